@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "alloc.h"
+#include "arena.h"
+
+// One free block. The same node sits in both treaps.
+typedef struct {
+    int base;
+    int size;
+    unsigned priority;
+    int left, right;         // Address treap
+    int maxSize;             // Largest size in the address subtree
+    int sizeLeft, sizeRight; // Size treap, ordered by (size, base)
+} FreeBlock;
+
+static FreeBlock* blocks = NULL;
+static int* unusedNodes = NULL; // Stack of pool nodes not holding a block
+static int numUnused = 0;
+static int byAddress = -1;
+static int bySize = -1;
+static int nextFitFrom = 0;
+static FitPolicy policy = FIT_FIRST;
+static unsigned seed = 2463534242u;
+static AllocStats stats;
+
+// Buddy mode: free blocks of size 1 << order, linked through their base address
+#define MAX_ORDER 31
+static int* buddyNext = NULL;
+static int* buddyPrev = NULL;
+static signed char* buddyOrder = NULL; // Order of the free block starting here, -1 if none
+static int buddyHead[MAX_ORDER];
+static int memoryWords = 0;
+
+static const char* policyNames[] = {"first", "best", "next", "buddy"};
+
+const char* fitPolicyName(FitPolicy fit) {
+    return fit >= FIT_FIRST && fit <= FIT_BUDDY ? policyNames[fit] : "unknown";
+}
+
+int parseFitPolicy(const char* name) {
+    for (int i = FIT_FIRST; i <= FIT_BUDDY; i++) {
+        if (strcmp(name, policyNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Fixed seed so placement, and with it the whole run, is reproducible
+static unsigned nextPriority(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void pull(int t) {
+    int largest = blocks[t].size;
+    int left = blocks[t].left;
+    int right = blocks[t].right;
+    if (left >= 0 && blocks[left].maxSize > largest) largest = blocks[left].maxSize;
+    if (right >= 0 && blocks[right].maxSize > largest) largest = blocks[right].maxSize;
+    blocks[t].maxSize = largest;
+}
+
+// Split into blocks below 'base' (lo) and the rest (hi)
+static void splitAddress(int t, int base, int* lo, int* hi) {
+    if (t < 0) {
+        *lo = *hi = -1;
+        return;
+    }
+    if (blocks[t].base < base) {
+        splitAddress(blocks[t].right, base, &blocks[t].right, hi);
+        *lo = t;
+    } else {
+        splitAddress(blocks[t].left, base, lo, &blocks[t].left);
+        *hi = t;
+    }
+    pull(t);
+}
+
+static int mergeAddress(int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (blocks[a].priority > blocks[b].priority) {
+        blocks[a].right = mergeAddress(blocks[a].right, b);
+        pull(a);
+        return a;
+    }
+    blocks[b].left = mergeAddress(a, blocks[b].left);
+    pull(b);
+    return b;
+}
+
+static int sizeBelow(int t, int size, int base) {
+    return blocks[t].size < size || (blocks[t].size == size && blocks[t].base < base);
+}
+
+// Split into blocks ordered before (size, base) (lo) and the rest (hi)
+static void splitSize(int t, int size, int base, int* lo, int* hi) {
+    if (t < 0) {
+        *lo = *hi = -1;
+        return;
+    }
+    if (sizeBelow(t, size, base)) {
+        splitSize(blocks[t].sizeRight, size, base, &blocks[t].sizeRight, hi);
+        *lo = t;
+    } else {
+        splitSize(blocks[t].sizeLeft, size, base, lo, &blocks[t].sizeLeft);
+        *hi = t;
+    }
+}
+
+static int mergeSize(int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    if (blocks[a].priority > blocks[b].priority) {
+        blocks[a].sizeRight = mergeSize(blocks[a].sizeRight, b);
+        return a;
+    }
+    blocks[b].sizeLeft = mergeSize(a, blocks[b].sizeLeft);
+    return b;
+}
+
+static void insertBlock(int t) {
+    int lo, hi;
+    blocks[t].left = blocks[t].right = -1;
+    blocks[t].sizeLeft = blocks[t].sizeRight = -1;
+    blocks[t].maxSize = blocks[t].size;
+    splitAddress(byAddress, blocks[t].base, &lo, &hi);
+    byAddress = mergeAddress(mergeAddress(lo, t), hi);
+    splitSize(bySize, blocks[t].size, blocks[t].base, &lo, &hi);
+    bySize = mergeSize(mergeSize(lo, t), hi);
+}
+
+static void removeBlock(int t) {
+    int lo, rest, self, hi;
+    splitAddress(byAddress, blocks[t].base, &lo, &rest);
+    splitAddress(rest, blocks[t].base + 1, &self, &hi);
+    byAddress = mergeAddress(lo, hi);
+    splitSize(bySize, blocks[t].size, blocks[t].base, &lo, &rest);
+    splitSize(rest, blocks[t].size, blocks[t].base + 1, &self, &hi);
+    bySize = mergeSize(lo, hi);
+}
+
+static int newBlock(int base, int size) {
+    int t = unusedNodes[--numUnused];
+    blocks[t].base = base;
+    blocks[t].size = size;
+    blocks[t].priority = nextPriority();
+    insertBlock(t);
+    stats.freeBlocks++;
+    return t;
+}
+
+static void dropBlock(int t) {
+    removeBlock(t);
+    unusedNodes[numUnused++] = t;
+    stats.freeBlocks--;
+}
+
+// Lowest-addressed block at or above 'from' with at least 'words' words
+static int findFit(int t, int words, int from) {
+    if (t < 0 || blocks[t].maxSize < words) return -1;
+    if (blocks[t].base >= from) {
+        int found = findFit(blocks[t].left, words, from);
+        if (found >= 0) return found;
+        if (blocks[t].size >= words) return t;
+    }
+    return findFit(blocks[t].right, words, from);
+}
+
+static int findBest(int words) {
+    int best = -1;
+    for (int t = bySize; t >= 0; ) {
+        if (blocks[t].size >= words) {
+            best = t;
+            t = blocks[t].sizeLeft;
+        } else {
+            t = blocks[t].sizeRight;
+        }
+    }
+    return best;
+}
+
+// Free block with the highest base below 'address'
+static int blockBelow(int address) {
+    int found = -1;
+    for (int t = byAddress; t >= 0; ) {
+        if (blocks[t].base < address) {
+            found = t;
+            t = blocks[t].right;
+        } else {
+            t = blocks[t].left;
+        }
+    }
+    return found;
+}
+
+// Free block with the lowest base at or above 'address'
+static int blockAbove(int address) {
+    int found = -1;
+    for (int t = byAddress; t >= 0; ) {
+        if (blocks[t].base >= address) {
+            found = t;
+            t = blocks[t].left;
+        } else {
+            t = blocks[t].right;
+        }
+    }
+    return found;
+}
+
+static void pushBuddy(int base, int order) {
+    buddyOrder[base] = order;
+    buddyPrev[base] = -1;
+    buddyNext[base] = buddyHead[order];
+    if (buddyHead[order] >= 0) buddyPrev[buddyHead[order]] = base;
+    buddyHead[order] = base;
+    stats.freeBlocks++;
+}
+
+static void unlinkBuddy(int base) {
+    int order = buddyOrder[base];
+    if (buddyPrev[base] >= 0) buddyNext[buddyPrev[base]] = buddyNext[base];
+    else buddyHead[order] = buddyNext[base];
+    if (buddyNext[base] >= 0) buddyPrev[buddyNext[base]] = buddyPrev[base];
+    buddyOrder[base] = -1;
+    stats.freeBlocks--;
+}
+
+static int orderFor(int words) {
+    int order = 0;
+    while ((1 << order) < words) order++;
+    return order;
+}
+
+static int buddyInit(int words) {
+    free(buddyNext);
+    free(buddyPrev);
+    free(buddyOrder);
+    buddyNext = heap_malloc(words * sizeof(int));
+    buddyPrev = heap_malloc(words * sizeof(int));
+    buddyOrder = heap_malloc(words);
+    if (!buddyNext || !buddyPrev || !buddyOrder) {
+        printf("memory error for the buddy free lists\n");
+        return -1;
+    }
+    memset(buddyOrder, -1, words);
+    for (int i = 0; i < MAX_ORDER; i++) {
+        buddyHead[i] = -1;
+    }
+    // Memory need not be a power of two: start from the largest aligned
+    // blocks that fit, which is one block per set bit of the size
+    for (int base = 0; base < words; ) {
+        int order = MAX_ORDER - 1;
+        while ((1 << order) > words - base || base % (1 << order) != 0) order--;
+        pushBuddy(base, order);
+        base += 1 << order;
+    }
+    return 0;
+}
+
+static int buddyAlloc(int words) {
+    int order = orderFor(words);
+    int from = order;
+    while (from < MAX_ORDER && buddyHead[from] < 0) from++;
+    if (from == MAX_ORDER) return -1;
+
+    int base = buddyHead[from];
+    unlinkBuddy(base);
+    while (from > order) {
+        from--;
+        pushBuddy(base + (1 << from), from);
+    }
+    stats.freeWords -= 1 << order;
+    stats.requestedWords += words;
+    stats.grantedWords += 1 << order;
+    stats.wastedWords += (1 << order) - words;
+    return base;
+}
+
+static void buddyFree(int base, int words) {
+    int order = orderFor(words);
+    if (base < 0 || base + (1 << order) > memoryWords || base % (1 << order) != 0 || buddyOrder[base] >= 0) {
+        printf("Region [%d,%d] is not an allocated buddy block\n", base, base + words - 1);
+        return;
+    }
+    stats.freeWords += 1 << order;
+    stats.wastedWords -= (1 << order) - words;
+    for (;;) {
+        int buddy = base ^ (1 << order);
+        if (buddy + (1 << order) > memoryWords || buddyOrder[buddy] != order) break;
+        unlinkBuddy(buddy);
+        if (buddy < base) base = buddy;
+        order++;
+    }
+    pushBuddy(base, order);
+}
+
+int alloc_init(int words, FitPolicy fit) {
+    // Free blocks are separated by at least one used word
+    int poolSize = words / 2 + 1;
+    free(blocks);
+    free(unusedNodes);
+    blocks = heap_malloc(poolSize * sizeof(FreeBlock));
+    unusedNodes = heap_malloc(poolSize * sizeof(int));
+    if (!blocks || !unusedNodes) {
+        printf("memory error for the free block index\n");
+        return -1;
+    }
+    numUnused = 0;
+    for (int i = poolSize - 1; i >= 0; i--) {
+        unusedNodes[numUnused++] = i;
+    }
+    byAddress = bySize = -1;
+    nextFitFrom = 0;
+    policy = fit;
+    memoryWords = words;
+    memset(&stats, 0, sizeof(stats));
+    stats.freeWords = words;
+    if (policy == FIT_BUDDY) return buddyInit(words);
+    if (words > 0) newBlock(0, words);
+    return 0;
+}
+
+int alloc_region(int words) {
+    if (words <= 0) return -1;
+    int t;
+    if (policy == FIT_BUDDY) {
+        int base = buddyAlloc(words);
+        if (base < 0) stats.failures++;
+        else stats.allocations++;
+        return base;
+    }
+    if (policy == FIT_BEST) {
+        t = findBest(words);
+    } else if (policy == FIT_NEXT) {
+        t = findFit(byAddress, words, nextFitFrom);
+        if (t < 0) t = findFit(byAddress, words, 0);
+    } else {
+        t = findFit(byAddress, words, 0);
+    }
+    if (t < 0) {
+        stats.failures++;
+        return -1;
+    }
+
+    int base = blocks[t].base;
+    int size = blocks[t].size;
+    dropBlock(t);
+    if (size > words) newBlock(base + words, size - words);
+    nextFitFrom = base + words;
+    stats.freeWords -= words;
+    stats.allocations++;
+    return base;
+}
+
+void free_region(int base, int words) {
+    if (words <= 0) return;
+    if (policy == FIT_BUDDY) {
+        buddyFree(base, words);
+        stats.frees++;
+        return;
+    }
+    int below = blockBelow(base);
+    int above = blockAbove(base);
+    if ((below >= 0 && blocks[below].base + blocks[below].size > base) ||
+        (above >= 0 && blocks[above].base < base + words)) {
+        printf("Region [%d,%d] is already free\n", base, base + words - 1);
+        return;
+    }
+
+    stats.freeWords += words;
+    stats.frees++;
+    if (below >= 0 && blocks[below].base + blocks[below].size == base) {
+        base = blocks[below].base;
+        words += blocks[below].size;
+        dropBlock(below);
+    }
+    if (above >= 0 && blocks[above].base == base + words) {
+        words += blocks[above].size;
+        dropBlock(above);
+    }
+    newBlock(base, words);
+}
+
+void alloc_compacted(int usedWords) {
+    while (byAddress >= 0) {
+        dropBlock(byAddress);
+    }
+    if (usedWords < memoryWords) newBlock(usedWords, memoryWords - usedWords);
+    nextFitFrom = usedWords;
+}
+
+void alloc_stats(AllocStats* out) {
+    *out = stats;
+    if (policy == FIT_BUDDY) {
+        out->largestFree = 0;
+        for (int order = MAX_ORDER - 1; order >= 0 && out->largestFree == 0; order--) {
+            if (buddyHead[order] >= 0) out->largestFree = 1 << order;
+        }
+    } else {
+        out->largestFree = byAddress >= 0 ? blocks[byAddress].maxSize : 0;
+    }
+}
@@ -0,0 +1,40 @@
+// alloc.h
+#ifndef ALLOC_H
+#define ALLOC_H
+
+// Placement policy for process images (the 'fit' setting)
+typedef enum {
+    FIT_FIRST, // Lowest address that fits
+    FIT_BEST,  // Smallest block that fits, lowest address on ties
+    FIT_NEXT,  // First fit starting where the previous allocation ended
+    FIT_BUDDY  // Power-of-two buddy blocks instead of the free list
+} FitPolicy;
+
+// Allocation counters since the last alloc_init
+typedef struct {
+    long allocations;
+    long frees;
+    long failures;   // Requests no free block could satisfy
+    int freeWords;
+    int freeBlocks;
+    int largestFree;
+    long requestedWords; // Buddy mode: words asked for over the run
+    long grantedWords;   // Buddy mode: block words handed out for them
+    int wastedWords;     // Buddy mode: rounding waste in blocks still allocated
+} AllocStats;
+
+// Free blocks of main memory are kept in two treaps over one node pool: one
+// ordered by address (with the largest size in each subtree, for first and
+// next fit and for finding neighbours to coalesce with) and one ordered by
+// size (for best fit). Every operation is O(log n) in the number of blocks.
+// Buddy mode instead keeps one intrusive free list per power-of-two order, so
+// allocating and freeing cost O(log memory size) splits or merges at most.
+int alloc_init(int words, FitPolicy fit); // Whole memory free, -1 if the index cannot be allocated
+int alloc_region(int words);              // Base address, or -1 when no free block is large enough
+void free_region(int base, int words);    // Returns the words, merging with free neighbours
+void alloc_compacted(int usedWords);      // Live images now fill [0, usedWords); not for buddy mode
+void alloc_stats(AllocStats* stats);
+const char* fitPolicyName(FitPolicy policy);
+int parseFitPolicy(const char* name);     // FitPolicy value, -1 if unknown
+
+#endif
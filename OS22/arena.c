@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "arena.h"
+
+typedef struct Chunk {
+    struct Chunk* next;
+    size_t size;
+    size_t used;
+    unsigned char* data;
+} Chunk;
+
+static Chunk* head = NULL;
+static Chunk* current = NULL; // Chunks after this one are empty
+static size_t inUse = 0;
+static ArenaStats stats;
+static atomic_long heapCalls = 0; // Cores stepped in parallel may allocate
+
+void* heap_malloc(size_t size) {
+    heapCalls++;
+    return malloc(size);
+}
+
+void* heap_calloc(size_t count, size_t size) {
+    heapCalls++;
+    return calloc(count, size);
+}
+
+void* heap_realloc(void* p, size_t size) {
+    heapCalls++;
+    return realloc(p, size);
+}
+
+long heap_allocations(void) {
+    return heapCalls;
+}
+
+// Offset of the next 16-byte aligned address in the chunk
+static size_t alignedStart(const Chunk* chunk) {
+    uintptr_t next = (uintptr_t)(chunk->data + chunk->used);
+    return chunk->used + ((16 - next % 16) % 16);
+}
+
+// New chunk linked in after 'after' (at the head if NULL)
+static Chunk* addChunk(Chunk* after, size_t size) {
+    if (size < ARENA_CHUNK_SIZE) size = ARENA_CHUNK_SIZE;
+    Chunk* chunk = heap_malloc(sizeof(Chunk) + size + 16);
+    if (chunk == NULL) {
+        printf("memory error for a scratch chunk of %zu bytes\n", size);
+        return NULL;
+    }
+    chunk->data = (unsigned char*)(chunk + 1);
+    chunk->size = size + 16; // Room for the first allocation to be aligned
+    chunk->used = 0;
+    if (after) {
+        chunk->next = after->next;
+        after->next = chunk;
+    } else {
+        chunk->next = head;
+        head = chunk;
+    }
+    stats.heapAllocations++;
+    stats.capacity += chunk->size;
+    return chunk;
+}
+
+void* arena_alloc(size_t size) {
+    if (current == NULL) {
+        current = head ? head : addChunk(NULL, size);
+        if (current == NULL) return NULL;
+        current->used = 0;
+    }
+    size_t start = alignedStart(current);
+    while (start + size > current->size) {
+        // The rest of this chunk is skipped; use the next one if it is big
+        // enough, otherwise replace it so the chunk list does not keep growing
+        Chunk* next = current->next;
+        if (next != NULL && next->size < size + 16) {
+            current->next = next->next;
+            stats.capacity -= next->size;
+            free(next);
+            next = NULL;
+        }
+        if (next == NULL) next = addChunk(current, size);
+        if (next == NULL) return NULL;
+        current = next;
+        current->used = 0;
+        start = alignedStart(current);
+    }
+    inUse += start - current->used + size;
+    current->used = start + size;
+    stats.allocations++;
+    if (inUse > stats.peakBytes) stats.peakBytes = inUse;
+    return current->data + start;
+}
+
+ArenaMark arena_mark(void) {
+    ArenaMark mark = {current, current ? current->used : 0, inUse};
+    return mark;
+}
+
+void arena_release(ArenaMark mark) {
+    current = mark.chunk;
+    if (current) current->used = mark.used;
+    inUse = mark.inUse;
+}
+
+void arena_reset(void) {
+    current = NULL;
+    inUse = 0;
+    stats.allocations = 0;
+    stats.peakBytes = 0;
+}
+
+void arena_stats(ArenaStats* out) {
+    *out = stats;
+    out->bytesInUse = inUse;
+}
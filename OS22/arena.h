@@ -0,0 +1,42 @@
+// arena.h
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_CHUNK_SIZE 65536 // Smallest chunk taken from the heap
+
+// Bump allocator for scratch buffers that live no longer than one operation
+// (loading a program, a compaction pass). Chunks are kept when space is given
+// back, so once a run has warmed up these buffers no longer touch the heap.
+typedef struct {
+    long heapAllocations; // Chunks taken from malloc since startup
+    long allocations;     // arena_alloc calls in this run
+    size_t bytesInUse;
+    size_t peakBytes;     // Most bytes in use at once in this run
+    size_t capacity;      // Bytes held in chunks
+} ArenaStats;
+
+// Position to roll back to; everything allocated after it is released at once
+typedef struct {
+    void* chunk;
+    size_t used;
+    size_t inUse;
+} ArenaMark;
+
+void* arena_alloc(size_t size); // 16-byte aligned, NULL if the heap is exhausted
+ArenaMark arena_mark(void);
+void arena_release(ArenaMark mark);
+void arena_reset(void);         // New run: everything is released and the counters restart
+void arena_stats(ArenaStats* stats);
+
+// Counted heap allocation. Everything the simulator takes from the heap (the
+// arena's chunks, tables, queue links, page tables, swap buffers) goes through
+// these, so a run can check that steady-state cycles allocate nothing.
+// They return NULL on failure like the calls they wrap; memory goes back with free().
+void* heap_malloc(size_t size);
+void* heap_calloc(size_t count, size_t size);
+void* heap_realloc(void* p, size_t size); // Counted even when the block grows in place
+long heap_allocations(void);              // Calls since startup
+
+#endif
@@ -0,0 +1,119 @@
+#!/bin/bash
+# Scaling benchmark: per-cycle cost of scheduler-cli as one limit grows while
+# the others stay at a size that fits the workload.
+#
+#   ./bench.sh [scheduler] [cycle cap]
+#
+# Each run loads copies of a small synthetic program that contends for the
+# userOutput mutex, so the scheduler, mutex and queue paths are all exercised.
+cd "$(dirname "$0")"
+SCHEDULER=${1:-mlfq}
+CYCLE_CAP=${2:-500}
+CLI=./scheduler-cli
+WORDS_PER_PROCESS=14 # 6 PCB words + 5 instructions + 3 variables
+
+if [ ! -x "$CLI" ]; then
+    make cli > /dev/null || exit 1
+fi
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+PROGRAM="$WORK/synthetic.txt"
+cat > "$PROGRAM" << 'EOF'
+semWait userOutput
+assign x 1
+assign y 5
+printFromTo x y
+semSignal userOutput
+EOF
+
+# run <label> <value> <processes> <memory_size> <queue_capacity> [key=value]...
+# Processes cycle through PROGRAMS when it is set, otherwise they all run PROGRAM.
+run() {
+    local args=()
+    local extra=()
+    local programs=("${PROGRAMS[@]:-$PROGRAM}")
+    for ((i = 0; i < $3; i++)); do args+=("${programs[i % ${#programs[@]}]}"); done
+    for limit in "${@:6}"; do extra+=(-l "$limit"); done
+    "$CLI" -s "$SCHEDULER" -m "$CYCLE_CAP" \
+        -l max_processes="$3" -l memory_size="$4" -l queue_capacity="$5" -l max_cycles=0 "${extra[@]}" \
+        "${args[@]}" < /dev/null 2> /dev/null |
+    awk -v label="$1" -v value="$2" '
+        /^Clock cycles:/ { cycles = $3 }
+        /^Instructions executed:/ { instructions = $3 }
+        /^Wall time:/ { seconds = $3 }
+        END {
+            printf "%-16s %10s %10d %12d %12.0f\n", label, value, cycles, instructions,
+                   (cycles > 0 ? seconds * 1e9 / cycles : 0)
+        }'
+}
+
+printf "%-16s %10s %10s %12s %12s\n" "dimension" "value" "cycles" "instructions" "ns/cycle"
+
+for n in 10 100 1000 4000; do
+    run max_processes "$n" "$n" $((n * WORDS_PER_PROCESS)) $((n + 1))
+done
+
+for words in 1000 10000 100000 1000000; do
+    run memory_size "$words" 10 "$words" 11
+done
+
+for capacity in 100 10000 1000000; do
+    run queue_capacity "$capacity" 10 $((10 * WORDS_PER_PROCESS)) "$capacity"
+done
+
+# SMP: the same contended workload spread over more simulated cores
+for cores in 1 8 64; do
+    run cores "$cores" 256 $((256 * WORDS_PER_PROCESS)) 257 cores="$cores"
+done
+
+# Balancers on a skewed load: short and long programs alternate, so with an
+# even core count every long one is first placed on an even-numbered core.
+# The cycles column is the makespan.
+SHORT="$WORK/short.txt"
+LONG="$WORK/long.txt"
+printf 'assign x 1\nassign y 2\n' > "$SHORT"
+for ((i = 1; i <= 10; i++)); do printf 'assign x %d\nprintFromTo x x\n' "$i"; done > "$LONG"
+PROGRAMS=("$SHORT" "$LONG")
+for balancer in push steal; do
+    for cost in 0 4; do
+        run balancer "$balancer/$cost" 64 2000 65 cores=8 balancer="$balancer" migration_cost="$cost"
+    done
+done
+
+# Host threads stepping 64 cores. Few steps touch a mutex here, so most run in
+# parallel; the -v log has to match the single-threaded one line for line.
+for threads in 1 2 4 8; do
+    run threads "$threads" 256 8000 257 cores=64 threads="$threads"
+    args=()
+    for ((i = 0; i < 256; i++)); do args+=("${PROGRAMS[i % 2]}"); done
+    "$CLI" -v -s "$SCHEDULER" -m "$CYCLE_CAP" -l max_processes=256 -l memory_size=8000 -l max_cycles=0 \
+        -l cores=64 -l threads="$threads" "${args[@]}" < /dev/null 2> /dev/null |
+        grep -v "^Wall\|^Throughput\|^Threads\|^Heap" > "$WORK/threads$threads.log"
+    if ! cmp -s "$WORK/threads1.log" "$WORK/threads$threads.log"; then
+        echo "threads=$threads: -v output differs from threads=1" >&2
+    fi
+done
+PROGRAMS=()
+
+# Regression: with -Q a process that uses up the lowest level's quantum must be
+# requeued there with a fresh one. 40 instructions outlast levels 0-2 (15).
+for ((i = 1; i <= 40; i++)); do echo "assign x $i"; done > "$WORK/bottom.txt"
+if ! "$CLI" -Q -s mlfq -m 1000 "$WORK/bottom.txt" < /dev/null 2> /dev/null | grep -q "^Processes: 1 loaded, 1 finished"; then
+    echo "-Q: a process at the lowest MLFQ level never finished" >&2
+fi
+
+# Paging: a program without the mutex so every process keeps touching its
+# pages, and far fewer frames than the images need so every policy evicts
+PROGRAM="$WORK/paged.txt"
+cat > "$PROGRAM" << 'EOF'
+assign x 1
+assign y 5
+printFromTo x y
+assign x 2
+printFromTo x y
+EOF
+
+for policy in fifo lru clock lfu; do
+    run page_policy "$policy" 200 128 201 page_size=2 page_policy="$policy"
+done
@@ -0,0 +1,301 @@
+// cli.c - headless batch runner for the scheduler simulation
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "main.h"
+#include "alloc.h"
+#include "swap.h"
+#include "paging.h"
+#include "arena.h"
+#include "smp.h"
+#include "workers.h"
+
+#define DEFAULT_CYCLE_LIMIT 1000000
+#define MAX_INPUTS 64
+
+static int verbose = 0;
+static const char *inputs[MAX_INPUTS];
+static int numInputs = 0;
+static int nextInput = 0;
+static unsigned long printedLog = 0; // Next log record to print
+
+// Frontend hooks: no widgets to refresh, new log records go to stdout when verbose
+void update_log_view(SimulationState *state) {
+    if (!verbose) return;
+    char line[1024];
+    for (; printedLog < state->log.next; printedLog++) {
+        const LogRecord *record = log_get(&state->log, printedLog);
+        if (record == NULL) continue;
+        log_format(record, line, sizeof(line));
+        printf("%s\n", line);
+    }
+}
+
+// Loads log why they fail; print that for runs that do not print the log
+static void printLoadErrors(unsigned long from) {
+    if (verbose) return;
+    char line[1024];
+    for (; from < sim_state.log.next; from++) {
+        const LogRecord *record = log_get(&sim_state.log, from);
+        if (record == NULL) continue;
+        log_format(record, line, sizeof(line));
+        fprintf(stderr, "%s\n", line);
+    }
+}
+
+void update_gui(SimulationState *state) {
+    state->dirty = 0;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-c config] [-l key=value]... [-s mlfq|rr|fcfs] [-q quantum] [-m max_cycles] [-i input]... [-Q] [-S] [-v] [-o logfile] [-a schedule] program[:arrival]...\n"
+            "  -c  read limits from a config file (key = value lines)\n"
+            "  -l  set one limit: memory_size (default %d), max_processes (%d),\n"
+            "      queue_capacity (%d, initial size, queues grow), max_cycles (%d, 0 = never warn),\n"
+            "      fit (first, best, next or buddy; default first),\n"
+            "      compact_threshold (%% of free memory outside the largest block, 0 = never),\n"
+            "      swap_file (backing store, unset = no swapping), swap_policy (fifo, largest or blocked),\n"
+            "      page_size (words per page, 0 = contiguous), tlb_entries (default %d),\n"
+            "      page_policy (fifo, lru, clock or lfu; default fifo),\n"
+            "      cores (simulated CPUs, up to %d), balance_interval (cycles between SMP balancing, default %d),\n"
+            "      balancer (push or steal; default push), migration_cost (cycles a core stalls per migration),\n"
+            "      threads (host threads stepping the cores, default %d)\n"
+            "  -s  scheduler (default mlfq)\n"
+            "  -q  Round-Robin quantum (default 4)\n"
+            "  -m  stop after this many clock cycles (default %d)\n"
+            "  -i  value for the next 'assign x input' (repeatable, stdin is read once exhausted)\n"
+            "  -Q  run a whole time quantum per scheduling decision instead of one instruction\n"
+            "  -S  step through idle cycles one at a time instead of jumping to the next arrival\n"
+            "  -v  print the execution log\n"
+            "  -o  write the last %d log records to a file when the run ends\n"
+            "  -a  also load the processes in a schedule file, one \"program [arrival [cpus]]\" per line\n",
+            prog, DEFAULT_MEMORY_SIZE, DEFAULT_MAX_PROCESSES, DEFAULT_QUEUE_CAPACITY, DEFAULT_MAX_CYCLES,
+            DEFAULT_TLB_ENTRIES, MAX_CORES, DEFAULT_BALANCE_INTERVAL, DEFAULT_THREADS, DEFAULT_CYCLE_LIMIT, LOG_CAPACITY);
+}
+
+// Answer a pending 'assign x input' from -i values, then from stdin
+static int supplyInput(void) {
+    char line[MAX_LINE_LENGTH];
+    const char *value;
+    if (nextInput < numInputs) {
+        value = inputs[nextInput++];
+    } else if (fgets(line, sizeof(line), stdin)) {
+        line[strcspn(line, "\n")] = 0;
+        value = line;
+    } else {
+        fprintf(stderr, "No input available for PID %d variable %s\n",
+                sim_state.waiting_for_input_pid, sim_state.waiting_for_input_var);
+        return -1;
+    }
+    updateVariable(sim_state.waiting_for_input_pid, sim_state.waiting_for_input_var, value);
+    sim_state.waiting_for_input_pid = 0;
+    sim_state.waiting_for_input_var[0] = '\0';
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int maxCycles = DEFAULT_CYCLE_LIMIT;
+    const char *logFile = NULL;
+    const char *schedule = NULL;
+    const char *scheduler = "mlfq";
+    int quantum = 0;
+    int wholeQuantum = 0;
+    int stepIdle = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:l:s:q:m:i:QSvo:a:h")) != -1) {
+        switch (opt) {
+            case 'c':
+                if (load_limits_file(optarg) != 0) return 2;
+                break;
+            case 'l':
+                if (parse_limit(optarg) != 0) return 2;
+                break;
+            case 's':
+                if (strcmp(optarg, "mlfq") != 0 && strcmp(optarg, "rr") != 0 && strcmp(optarg, "fcfs") != 0) {
+                    fprintf(stderr, "Unknown scheduler: %s\n", optarg);
+                    return 2;
+                }
+                scheduler = optarg;
+                break;
+            case 'q':
+                quantum = atoi(optarg);
+                if (quantum <= 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'm': maxCycles = atoi(optarg); break;
+            case 'i':
+                if (numInputs < MAX_INPUTS) inputs[numInputs++] = optarg;
+                break;
+            case 'Q': wholeQuantum = 1; break;
+            case 'S': stepIdle = 1; break;
+            case 'v': verbose = 1; break;
+            case 'o': logFile = optarg; break;
+            case 'a': schedule = optarg; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc && schedule == NULL) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Limits are final now; everything is allocated from them
+    if (init_simulation(&sim_state) != 0) return 1;
+    strcpy(sim_state.schedulerType, scheduler);
+    if (quantum > 0) sim_state.rrQuantum = quantum;
+    sim_state.runWholeQuantum = wholeQuantum;
+    sim_state.stepIdleCycles = stepIdle;
+    sim_state.cycleLimit = maxCycles;
+
+    for (int i = optind; i < argc; i++) {
+        char filename[MAX_LINE_LENGTH];
+        int arrival = 0;
+        snprintf(filename, sizeof(filename), "%s", argv[i]);
+        char *sep = strrchr(filename, ':');
+        if (sep) {
+            *sep = '\0';
+            arrival = atoi(sep + 1);
+        }
+        int before = sim_state.numProcesses;
+        unsigned long logged = sim_state.log.next;
+        add_process(&sim_state, filename, arrival);
+        if (sim_state.numProcesses == before) {
+            fprintf(stderr, "Failed to load %s\n", filename);
+            printLoadErrors(logged);
+            return 1;
+        }
+    }
+    unsigned long logged = sim_state.log.next;
+    if (schedule != NULL && load_arrival_schedule(&sim_state, schedule) < 0) {
+        printLoadErrors(logged);
+        return 1;
+    }
+    // Logged while loading so a failure can say why; quiet from here on
+    sim_state.quiet = !verbose && logFile == NULL;
+    int loaded = sim_state.numProcesses;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long warmupChunks = -1; // Scratch chunks taken by the end of the first cycle
+    long warmupHeap = heap_allocations(); // Heap calls by the end of the first cycle
+    while (sim_state.numProcesses > 0 && sim_state.clockCycle < maxCycles) {
+        run_simulation_cycle(&sim_state);
+        if (warmupChunks < 0) {
+            ArenaStats arena;
+            arena_stats(&arena);
+            warmupChunks = arena.heapAllocations;
+            warmupHeap = heap_allocations();
+        }
+        if (sim_state.waiting_for_input_pid > 0 && supplyInput() != 0) {
+            break;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Scheduler: %s\n", sim_state.schedulerType);
+    printf("Processes: %d loaded, %d finished, %d unfinished\n",
+           loaded, loaded - sim_state.numProcesses, sim_state.numProcesses);
+    printf("Clock cycles: %d\n", sim_state.clockCycle);
+    printf("Instructions executed: %ld\n", sim_state.instructionsExecuted);
+    printf("Wall time: %.6f s\n", seconds);
+    if (seconds > 0) {
+        printf("Throughput: %.0f cycles/s, %.0f instructions/s\n",
+               sim_state.clockCycle / seconds, sim_state.instructionsExecuted / seconds);
+    }
+    if (sim_state.idleJumps > 0) {
+        printf("Idle skipping: %ld idle cycles skipped in %ld jumps\n",
+               sim_state.idleCyclesSkipped, sim_state.idleJumps);
+    }
+    if (smp_enabled()) {
+        SmpStats smp;
+        smp_stats(&smp);
+        if (smp.balancer == BALANCE_STEAL) {
+            printf("SMP: %d cores, steal balancer: %ld steal attempts, %ld steals (%.1f%%), %ld migrations\n",
+                   smp.cores, smp.stealAttempts, smp.steals,
+                   smp.stealAttempts > 0 ? 100.0 * smp.steals / smp.stealAttempts : 0.0, smp.migrations);
+        } else {
+            printf("SMP: %d cores, push balancer: %ld balancing passes, %ld migrations\n",
+                   smp.cores, smp.balancePasses, smp.migrations);
+        }
+        if (smp.migrationCycles > 0) {
+            printf("Migration cost: %ld cycles charged\n", smp.migrationCycles);
+        }
+        if (workers_count() > 1) {
+            long steps = sim_state.parallelSteps + sim_state.serialSteps;
+            printf("Threads: %d, %ld of %ld core steps run in parallel (%.1f%%)\n", workers_count(),
+                   sim_state.parallelSteps, steps, steps > 0 ? 100.0 * sim_state.parallelSteps / steps : 0.0);
+        }
+        for (int c = 0; c < smp.cores; c++) {
+            Core *core = smp_core(c);
+            printf("  CPU %d: %.1f%% busy (%ld cycles), %ld migrations in, %ld out", c,
+                   sim_state.clockCycle > 0 ? 100.0 * core->busyCycles / sim_state.clockCycle : 0.0,
+                   core->busyCycles, core->migrationsIn, core->migrationsOut);
+            if (smp.balancer == BALANCE_STEAL) printf(", %ld steal attempts", core->stealAttempts);
+            if (core->stalledCycles > 0) printf(", %ld cycles stalled", core->stalledCycles);
+            printf("\n");
+        }
+    }
+    if (paging_enabled()) {
+        PagingStats paging;
+        paging_stats(&paging);
+        printf("Paging (%d-word pages, %d frames, %d TLB entries): %ld translations (%.2f per cycle), "
+               "TLB %ld hits, %ld misses (%.1f%% hit rate)\n",
+               limits.pageSize, paging.frames, limits.tlbEntries, paging.translations,
+               sim_state.clockCycle > 0 ? (double)paging.translations / sim_state.clockCycle : 0.0,
+               paging.tlbHits, paging.tlbMisses,
+               paging.translations > 0 ? 100.0 * paging.tlbHits / paging.translations : 0.0);
+        printf("Page replacement (%s): %ld page faults (%.2f%% of translations), %ld evictions\n",
+               replacementPolicyName(limits.pagePolicy), paging.pageFaults,
+               paging.translations > 0 ? 100.0 * paging.pageFaults / paging.translations : 0.0,
+               paging.evictions);
+    } else {
+        AllocStats memoryStats;
+        alloc_stats(&memoryStats);
+        printf("Memory (fit = %s): %ld allocations, %ld frees, %ld failed; %d words free in %d blocks, largest %d\n",
+               fitPolicyName(limits.fit), memoryStats.allocations, memoryStats.frees, memoryStats.failures,
+               memoryStats.freeWords, memoryStats.freeBlocks, memoryStats.largestFree);
+        if (sim_state.compactions > 0) {
+            printf("Compaction: %ld passes, %ld words moved, %ld cycles charged\n",
+                   sim_state.compactions, sim_state.wordsCompacted, sim_state.compactionCycles);
+        }
+        if (limits.fit == FIT_BUDDY && memoryStats.grantedWords > 0) {
+            printf("Internal fragmentation: %ld of %ld granted words unused (%.1f%%), %d in live blocks\n",
+                   memoryStats.grantedWords - memoryStats.requestedWords, memoryStats.grantedWords,
+                   100.0 * (memoryStats.grantedWords - memoryStats.requestedWords) / memoryStats.grantedWords,
+                   memoryStats.wastedWords);
+        }
+    }
+    if (swap_enabled()) {
+        SwapStats swapStats;
+        swap_stats(&swapStats);
+        printf("Swap (%s): %ld out, %ld in, %ld bytes written, %ld read, %.6f s I/O, file %d pages\n",
+               victimPolicyName(limits.swapPolicy), swapStats.swapOuts, swapStats.swapIns,
+               swapStats.bytesWritten, swapStats.bytesRead, swapStats.seconds, swapStats.filePages);
+    }
+    ArenaStats arena;
+    arena_stats(&arena);
+    printf("Scratch arena: %ld allocations, peak %zu bytes, %ld heap chunks (%ld after the first cycle)\n",
+           arena.allocations, arena.peakBytes, arena.heapAllocations,
+           warmupChunks < 0 ? 0 : arena.heapAllocations - warmupChunks);
+    printf("Heap: %ld allocations, %ld after the first cycle\n",
+           heap_allocations(), heap_allocations() - warmupHeap);
+
+    if (logFile != NULL) {
+        FILE *out = fopen(logFile, "w");
+        if (!out) {
+            fprintf(stderr, "Cannot write log to %s\n", logFile);
+            return 1;
+        }
+        log_export(&sim_state.log, out);
+        fclose(out);
+    }
+    return sim_state.numProcesses == 0 ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "config.h"
+#include "alloc.h"
+#include "swap.h"
+#include "paging.h"
+#include "smp.h"
+
+SimulationLimits limits = {
+    DEFAULT_MEMORY_SIZE,
+    DEFAULT_MAX_PROCESSES,
+    DEFAULT_QUEUE_CAPACITY,
+    DEFAULT_MAX_CYCLES,
+    DEFAULT_FIT,
+    DEFAULT_COMPACT_THRESHOLD,
+    DEFAULT_SWAP_POLICY,
+    "",
+    DEFAULT_PAGE_SIZE,
+    DEFAULT_TLB_ENTRIES,
+    DEFAULT_PAGE_POLICY,
+    DEFAULT_CORES,
+    DEFAULT_BALANCE_INTERVAL,
+    DEFAULT_BALANCER,
+    DEFAULT_MIGRATION_COST,
+    DEFAULT_THREADS
+};
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return s;
+}
+
+int set_limit(const char* key, const char* value) {
+    if (strcmp(key, "fit") == 0) {
+        int fit = parseFitPolicy(value);
+        if (fit < 0) {
+            printf("Invalid value '%s' for fit (first, best, next or buddy)\n", value);
+            return -1;
+        }
+        limits.fit = fit;
+        return 0;
+    }
+    if (strcmp(key, "swap_policy") == 0) {
+        int policy = parseVictimPolicy(value);
+        if (policy < 0) {
+            printf("Invalid value '%s' for swap_policy (fifo, largest or blocked)\n", value);
+            return -1;
+        }
+        limits.swapPolicy = policy;
+        return 0;
+    }
+    if (strcmp(key, "page_policy") == 0) {
+        int policy = parseReplacementPolicy(value);
+        if (policy < 0) {
+            printf("Invalid value '%s' for page_policy (fifo, lru, clock or lfu)\n", value);
+            return -1;
+        }
+        limits.pagePolicy = policy;
+        return 0;
+    }
+    if (strcmp(key, "balancer") == 0) {
+        int policy = parseBalancePolicy(value);
+        if (policy < 0) {
+            printf("Invalid value '%s' for balancer (push or steal)\n", value);
+            return -1;
+        }
+        limits.balancer = policy;
+        return 0;
+    }
+    if (strcmp(key, "swap_file") == 0) {
+        snprintf(limits.swapFile, sizeof(limits.swapFile), "%s", value);
+        return 0;
+    }
+
+    char* end;
+    long number = strtol(value, &end, 10);
+    if (end == value || *end != '\0' || number < 0 || number > 100000000) {
+        printf("Invalid value '%s' for %s\n", value, key);
+        return -1;
+    }
+
+    if (strcmp(key, "memory_size") == 0 && number > 0) {
+        limits.memorySize = number;
+    } else if (strcmp(key, "max_processes") == 0 && number > 0) {
+        limits.maxProcesses = number;
+    } else if (strcmp(key, "queue_capacity") == 0 && number > 0) {
+        limits.queueCapacity = number;
+    } else if (strcmp(key, "max_cycles") == 0) {
+        limits.maxCycles = number;
+    } else if (strcmp(key, "compact_threshold") == 0 && number <= 100) {
+        limits.compactThreshold = number;
+    } else if (strcmp(key, "page_size") == 0) {
+        limits.pageSize = number;
+    } else if (strcmp(key, "tlb_entries") == 0 && number > 0) {
+        limits.tlbEntries = number;
+    } else if (strcmp(key, "cores") == 0 && number > 0 && number <= MAX_CORES) {
+        limits.cores = number;
+    } else if (strcmp(key, "balance_interval") == 0) {
+        limits.balanceInterval = number;
+    } else if (strcmp(key, "migration_cost") == 0) {
+        limits.migrationCost = number;
+    } else if (strcmp(key, "threads") == 0 && number > 0 && number <= MAX_CORES) {
+        limits.threads = number;
+    } else {
+        printf("Unknown limit or invalid value: %s = %s\n", key, value);
+        return -1;
+    }
+    return 0;
+}
+
+int parse_limit(const char* assignment) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%s", assignment);
+    char* sep = strchr(buffer, '=');
+    if (!sep) {
+        printf("Expected key=value, got '%s'\n", assignment);
+        return -1;
+    }
+    *sep = '\0';
+    return set_limit(trim(buffer), trim(sep + 1));
+}
+
+int load_limits_file(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        printf("Error opening config file: %s\n", path);
+        return -1;
+    }
+    char line[128];
+    int lineNumber = 0;
+    int result = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        char* text = trim(line);
+        if (*text == '\0') continue;
+        if (parse_limit(text) != 0) {
+            printf("%s:%d: bad setting\n", path, lineNumber);
+            result = -1;
+        }
+    }
+    fclose(file);
+    return result;
+}
@@ -0,0 +1,50 @@
+// config.h
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// Defaults, matching the sizes the simulator was originally built with
+#define DEFAULT_MEMORY_SIZE 60
+#define DEFAULT_MAX_PROCESSES 10
+#define DEFAULT_QUEUE_CAPACITY 100
+#define DEFAULT_MAX_CYCLES 100
+#define DEFAULT_FIT 0 // FIT_FIRST, see alloc.h
+#define DEFAULT_COMPACT_THRESHOLD 0
+#define DEFAULT_SWAP_POLICY 0 // VICTIM_FIFO, see swap.h
+#define DEFAULT_PAGE_SIZE 0
+#define DEFAULT_TLB_ENTRIES 16
+#define DEFAULT_PAGE_POLICY 0 // PAGE_FIFO, see paging.h
+#define DEFAULT_CORES 1
+#define DEFAULT_BALANCE_INTERVAL 4
+#define DEFAULT_BALANCER 0 // BALANCE_PUSH, see smp.h
+#define DEFAULT_MIGRATION_COST 0
+#define DEFAULT_THREADS 1
+#define MAX_CORES 64 // Affinity masks have one bit per core
+
+// Sizes chosen at startup. They are read by init_simulation, so set them
+// (from a config file or the command line) before it runs.
+typedef struct {
+    int memorySize;    // Words of main memory
+    int maxProcesses;  // Process table slots
+    int queueCapacity; // Initial PID links per queue; queues grow as needed
+    int maxCycles;     // MLFQ reports a possible deadlock past this cycle, 0 = never
+    int fit;           // FitPolicy used to place process images
+    int compactThreshold; // Compact when this % of free memory is outside the largest block, 0 = never
+    int swapPolicy;    // VictimPolicy for swapping out
+    char swapFile[256]; // Backing store for swapped-out images, empty = no swapping
+    int pageSize;      // Words per page and frame, 0 = contiguous images
+    int tlbEntries;    // Translations cached in paging mode
+    int pagePolicy;    // ReplacementPolicy for choosing a frame to evict
+    int cores;         // Simulated CPUs, each with its own run queues
+    int balanceInterval; // Cycles between load-balancing passes in SMP mode, 0 = never
+    int balancer;      // BalancePolicy for moving work between cores
+    int migrationCost; // Cycles a core stalls after a process migrates to it
+    int threads;       // Host threads stepping the cores of an SMP cycle
+} SimulationLimits;
+
+extern SimulationLimits limits;
+
+int set_limit(const char* key, const char* value);  // Returns -1 for an unknown key or bad value
+int parse_limit(const char* assignment);             // "key=value"
+int load_limits_file(const char* path);              // "key = value" lines, '#' comments
+
+#endif
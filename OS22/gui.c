@@ -2,8 +2,7 @@
 #include <gtk/gtkentry.h>
 #include <string.h>
 #include "main.h"
-
-#define NUM_QUEUES 4
+#include "paging.h"
 
 static GtkWidget *window = NULL;
 static guint auto_timer_id = 0;
@@ -23,210 +22,349 @@ static GtkWidget *auto_button;
 static GtkWidget *mutex_grid;
 static GtkWidget *log_text_view;
 static GtkWidget *add_process_button;
+static GtkWidget *compact_button;
 static GtkWidget *arrival_spin;
 static GtkWidget *log_entry;
 
 // List stores for dynamic data
-static GListStore *process_store;
-static GListStore *queue_store;
 
-static GListStore *memory_store = NULL;
+// Memory viewer model: one item per word, created only when the grid view
+// asks for it, so only visible cells ever exist as objects and widgets
+#define MEMORY_TYPE_WORD (memory_word_get_type())
+G_DECLARE_FINAL_TYPE(MemoryWord, memory_word, MEMORY, WORD, GObject)
+
+struct _MemoryWord {
+    GObject parent_instance;
+    int address;
+};
+
+G_DEFINE_TYPE(MemoryWord, memory_word, G_TYPE_OBJECT)
+
+static void memory_word_class_init(MemoryWordClass *klass) {}
+static void memory_word_init(MemoryWord *self) {}
+
+#define MEMORY_TYPE_MODEL (memory_model_get_type())
+G_DECLARE_FINAL_TYPE(MemoryModel, memory_model, MEMORY, MODEL, GObject)
+
+struct _MemoryModel {
+    GObject parent_instance;
+};
+
+static GType memory_model_get_item_type(GListModel *list) {
+    return MEMORY_TYPE_WORD;
+}
+
+static guint memory_model_get_n_items(GListModel *list) {
+    return limits.memorySize;
+}
+
+static gpointer memory_model_get_item(GListModel *list, guint position) {
+    if (position >= (guint)limits.memorySize) return NULL;
+    MemoryWord *word = g_object_new(MEMORY_TYPE_WORD, NULL);
+    word->address = position;
+    return word;
+}
+
+static void memory_model_list_model_init(GListModelInterface *iface) {
+    iface->get_item_type = memory_model_get_item_type;
+    iface->get_n_items = memory_model_get_n_items;
+    iface->get_item = memory_model_get_item;
+}
+
+G_DEFINE_TYPE_WITH_CODE(MemoryModel, memory_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, memory_model_list_model_init))
+
+static void memory_model_class_init(MemoryModelClass *klass) {}
+static void memory_model_init(MemoryModel *self) {}
+
+static MemoryModel *memory_model = NULL;
 
-static GtkWidget *memory_grid_viewer = NULL;
+static guint gui_tick_id = 0; // Pending frame callback for update_gui
 
+static unsigned long shown_log = 0; // Next log record to insert into the text view
+static guint log_idle_id = 0;
+
+// Format and insert every record logged since the last refresh, once per main loop pass
 static gboolean update_log_idle(gpointer user_data) {
-    const char *message = (const char *)user_data;
-    if (log_text_view != NULL) {
-        GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(log_text_view));
-        if (buffer != NULL) {
-            GtkTextIter end;
-            gtk_text_buffer_get_end_iter(buffer, &end);
-            gtk_text_buffer_insert(buffer, &end, message, -1);
-            gtk_text_buffer_insert(buffer, &end, "\n", -1);
-            gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(log_text_view), &end, 0.0, TRUE, 0.0, 1.0);
-            gtk_widget_queue_draw(log_text_view);
-        }
+    log_idle_id = 0;
+    if (log_text_view == NULL) return G_SOURCE_REMOVE;
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(log_text_view));
+    if (buffer == NULL) return G_SOURCE_REMOVE;
+
+    EventLog *log = &sim_state.log;
+    if (shown_log < log_oldest(log)) {
+        shown_log = log_oldest(log); // Overwritten before we got to show them
+    }
+    GtkTextIter end;
+    gtk_text_buffer_get_end_iter(buffer, &end);
+    char line[1024];
+    for (; shown_log < log->next; shown_log++) {
+        log_format(log_get(log, shown_log), line, sizeof(line));
+        gtk_text_buffer_insert(buffer, &end, line, -1);
+        gtk_text_buffer_insert(buffer, &end, "\n", -1);
+    }
+    // Keep the view as bounded as the log itself
+    int extra = gtk_text_buffer_get_line_count(buffer) - 1 - LOG_CAPACITY;
+    if (extra > 0) {
+        GtkTextIter start, cut;
+        gtk_text_buffer_get_start_iter(buffer, &start);
+        gtk_text_buffer_get_iter_at_line(buffer, &cut, extra);
+        gtk_text_buffer_delete(buffer, &start, &cut);
+        gtk_text_buffer_get_end_iter(buffer, &end);
     }
-    g_free(user_data);
+    gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(log_text_view), &end, 0.0, TRUE, 0.0, 1.0);
+    gtk_widget_queue_draw(log_text_view);
     return G_SOURCE_REMOVE;
 }
 
-void append_log(SimulationState *state, const char *message) {
-    char formatted_message[1024];
-    if (state->runningPid > 0) {
-        snprintf(formatted_message, sizeof(formatted_message), 
-                "[Cycle %d] [PID %d] %s", 
-                state->clockCycle,
-                state->runningPid,
-                message);
+void update_log_view(SimulationState *state) {
+    if (log_idle_id == 0) {
+        log_idle_id = g_idle_add(update_log_idle, NULL);
+    }
+}
+
+// Rows currently shown by a list panel, keyed so a refresh can update them in
+// place and only emit items-changed for rows whose text actually changed. The
+// time in queue changes every cycle, so it is not part of the row text; each
+// bound row shows it in a label of its own, see update_time_labels
+#define ROW_TEXT_LENGTH 128
+
+typedef struct {
+    GListStore *store;
+    int count;
+    int capacity;
+    int cursor; // Next row to match while a refresh is in progress
+    int *keys;
+    char (*text)[ROW_TEXT_LENGTH];
+    int *rowOf;   // Row showing each key, -1 if none; indexed by key
+    int keyLimit; // Keys below this have a rowOf entry
+} ListPanel;
+
+static void init_list_panel(ListPanel *panel) {
+    panel->store = g_list_store_new(GTK_TYPE_STRING_OBJECT);
+    panel->capacity = limits.maxProcesses * 2;
+    panel->keys = g_new0(int, panel->capacity);
+    panel->text = g_malloc0_n(panel->capacity, ROW_TEXT_LENGTH);
+    panel->rowOf = NULL;
+    panel->keyLimit = 0;
+}
+
+static int panel_lookup(ListPanel *panel, int key) {
+    return key >= 0 && key < panel->keyLimit ? panel->rowOf[key] : -1;
+}
+
+static void panel_reserve_key(ListPanel *panel, int key) {
+    if (key < panel->keyLimit) return;
+    int limit = panel->keyLimit > 0 ? panel->keyLimit : 64;
+    while (limit <= key) limit *= 2;
+    panel->rowOf = g_renew(int, panel->rowOf, limit);
+    for (int i = panel->keyLimit; i < limit; i++) panel->rowOf[i] = -1;
+    panel->keyLimit = limit;
+}
+
+// Rows from 'first' on moved; point their keys at their new positions
+static void panel_renumber(ListPanel *panel, int first) {
+    for (int i = first; i < panel->count; i++) {
+        panel->rowOf[panel->keys[i]] = i;
+    }
+}
+
+static ListPanel process_panel;
+static ListPanel queue_panel;
+
+static void panel_splice(ListPanel *panel, int position, int removals, int pid, const char *text) {
+    GtkStringObject *item = text ? gtk_string_object_new(text) : NULL;
+    if (item) g_object_set_data(G_OBJECT(item), "pid", GINT_TO_POINTER(pid));
+    g_list_store_splice(panel->store, position, removals, (gpointer *)&item, item ? 1 : 0);
+    if (item) g_object_unref(item);
+}
+
+static void panel_begin(ListPanel *panel) {
+    panel->cursor = 0;
+}
+
+// Room for twice the rows, so a panel never drops one
+static int panel_grow(ListPanel *panel) {
+    int capacity = panel->capacity > 0 ? panel->capacity * 2 : 64;
+    int *keys = g_try_renew(int, panel->keys, capacity);
+    if (keys == NULL) return -1;
+    panel->keys = keys;
+    char (*text)[ROW_TEXT_LENGTH] = g_try_realloc_n(panel->text, capacity, ROW_TEXT_LENGTH);
+    if (text == NULL) return -1;
+    panel->text = text;
+    panel->capacity = capacity;
+    return 0;
+}
+
+static void panel_row(ListPanel *panel, int key, int pid, const char *text) {
+    int row = panel->cursor;
+    int found = panel_lookup(panel, key);
+    if (found < row) found = -1;
+    if (found > row) {
+        // Rows in between belong to processes that left this panel
+        g_list_store_splice(panel->store, row, found - row, NULL, 0);
+        for (int i = row; i < found; i++) panel->rowOf[panel->keys[i]] = -1;
+        memmove(&panel->keys[row], &panel->keys[found], (panel->count - found) * sizeof(panel->keys[0]));
+        memmove(&panel->text[row], &panel->text[found], (panel->count - found) * sizeof(panel->text[0]));
+        panel->count -= found - row;
+        panel_renumber(panel, row);
+        found = row;
+    }
+    if (found == row) {
+        if (strcmp(panel->text[row], text) != 0) {
+            panel_splice(panel, row, 1, pid, text);
+            snprintf(panel->text[row], ROW_TEXT_LENGTH, "%s", text);
+        }
     } else {
-        snprintf(formatted_message, sizeof(formatted_message), 
-                "%s", 
-                message);
+        if (panel->count == panel->capacity && panel_grow(panel) != 0) {
+            g_warning("list panel full at %d rows, PID %d not shown", panel->count, pid);
+            return;
+        }
+        panel_reserve_key(panel, key);
+        panel_splice(panel, row, 0, pid, text);
+        memmove(&panel->keys[row + 1], &panel->keys[row], (panel->count - row) * sizeof(panel->keys[0]));
+        memmove(&panel->text[row + 1], &panel->text[row], (panel->count - row) * sizeof(panel->text[0]));
+        panel->keys[row] = key;
+        snprintf(panel->text[row], ROW_TEXT_LENGTH, "%s", text);
+        panel->count++;
+        panel_renumber(panel, row);
     }
-    strncat(state->log, formatted_message, MAX_LOG_LENGTH - strlen(state->log) - 1);
-    strncat(state->log, "\n", MAX_LOG_LENGTH - strlen(state->log) - 1);
-    char *message_copy = g_strdup(formatted_message);
-    g_idle_add(update_log_idle, message_copy);
+    panel->cursor++;
 }
 
-void update_process_list() {
-    if (!G_IS_LIST_STORE(process_store)) return;
-    g_list_store_remove_all(process_store);
-    
+static void panel_end(ListPanel *panel) {
+    if (panel->cursor < panel->count) {
+        g_list_store_splice(panel->store, panel->cursor, panel->count - panel->cursor, NULL, 0);
+        for (int i = panel->cursor; i < panel->count; i++) panel->rowOf[panel->keys[i]] = -1;
+        panel->count = panel->cursor;
+    }
+}
+
+static void update_process_list() {
+    if (!G_IS_LIST_STORE(process_panel.store)) return;
+    char text[ROW_TEXT_LENGTH];
+    panel_begin(&process_panel);
     for (int i = 0; i < sim_state.numProcesses; i++) {
         ProcessInfo *info = &sim_state.processes[i];
-        char *display_text = g_strdup_printf(
-            "PID: %d | State: %s | Queue: %d | PC: %d | Memory: %d-%d | Time in Queue: %d",
+        snprintf(text, sizeof(text),
+            "PID: %d | State: %s | Queue: %d | PC: %d | Memory: %d-%d",
             info->pid,
-            info->state,
+            processStateName(info->state),
             info->priority,
             info->pc,
             info->lowerBound,
-            info->upperBound,
-            info->timeInQueue);
- 
-        GObject *item = G_OBJECT(gtk_string_object_new(display_text));
-        g_list_store_append(process_store, item);
-        g_object_unref(item);
-        g_free(display_text);
+            info->upperBound);
+        panel_row(&process_panel, info->pid, info->pid, text);
     }
+    panel_end(&process_panel);
 }
 
-void update_queue_list() {
-    if (!G_IS_LIST_STORE(queue_store)) return;
-    g_list_store_remove_all(queue_store);
-    
-    if (sim_state.runningPid > 0) {
-        for (int i = 0; i < sim_state.numProcesses; i++) {
-            if (sim_state.processes[i].pid == sim_state.runningPid) {
-                char *display_text = g_strdup_printf(
-                    "RUNNING | PID: %d | Time: %d | Queue: %d",
-                    sim_state.processes[i].pid,
-                    sim_state.processes[i].timeInQueue,
-                    sim_state.processes[i].priority);
-                GObject *item = G_OBJECT(gtk_string_object_new(display_text));
-                g_list_store_append(queue_store, item);
-                g_object_unref(item);
-                g_free(display_text);
-                break;
-            }
-        }
-    }
+// Queue rows are keyed by section and PID: running, MLFQ levels, then blocked
+enum { QUEUE_ROW_RUNNING = 0, QUEUE_ROW_READY = 1, QUEUE_ROW_BLOCKED = NUM_QUEUES + 1 };
+#define QUEUE_ROW_KEY(section, pid) ((pid) * (NUM_QUEUES + 2) + (section))
 
-    static Queue mlfq_queues[NUM_QUEUES];
-    static int initialized = 0;
-    if (!initialized) {
-        for (int i = 0; i < NUM_QUEUES; i++) {
-            initializeQueue(&mlfq_queues[i]);
-        }
-        initialized = 1;
-    }
+static void update_queue_list() {
+    if (!G_IS_LIST_STORE(queue_panel.store)) return;
+    char text[ROW_TEXT_LENGTH];
+    panel_begin(&queue_panel);
 
-    for (int i = 0; i < NUM_QUEUES; i++) {
-        while (!isEmpty(&mlfq_queues[i])) {
-            dequeue(&mlfq_queues[i]);
-        }
+    ProcessInfo *running = sim_state.runningPid > 0 ? processInfo(sim_state.runningPid) : NULL;
+    if (running) {
+        snprintf(text, sizeof(text), "RUNNING | PID: %d | Queue: %d",
+                 running->pid, running->priority);
+        panel_row(&queue_panel, QUEUE_ROW_KEY(QUEUE_ROW_RUNNING, running->pid), running->pid, text);
     }
 
+    // Ready processes grouped by level in one pass: count each level, then
+    // place every process after the levels above it (PID order within a level)
+    static int *by_level = NULL;
+    static int by_level_size = 0;
+    if (by_level_size < sim_state.numProcesses) {
+        by_level_size = limits.maxProcesses > sim_state.numProcesses ? limits.maxProcesses : sim_state.numProcesses;
+        by_level = g_renew(int, by_level, by_level_size);
+    }
+    int start[NUM_QUEUES + 1] = {0};
     for (int i = 0; i < sim_state.numProcesses; i++) {
         ProcessInfo *info = &sim_state.processes[i];
-        if (info && strcmp(info->state, "Ready") == 0) {
-            int queue_index = info->priority;
-            if (queue_index >= 0 && queue_index < NUM_QUEUES) {
-                enqueue(&mlfq_queues[queue_index], info->pid);
-            }
-        }
+        if (info->state == READY && info->priority >= 0 && info->priority < NUM_QUEUES) start[info->priority + 1]++;
+    }
+    for (int q = 0; q < NUM_QUEUES; q++) start[q + 1] += start[q];
+    int next[NUM_QUEUES];
+    memcpy(next, start, sizeof(next));
+    for (int i = 0; i < sim_state.numProcesses; i++) {
+        ProcessInfo *info = &sim_state.processes[i];
+        if (info->state == READY && info->priority >= 0 && info->priority < NUM_QUEUES) by_level[next[info->priority]++] = i;
     }
-
     for (int q = 0; q < NUM_QUEUES; q++) {
-        if (isEmpty(&mlfq_queues[q])) continue;
-
-        Queue tempQueue;
-        initializeQueue(&tempQueue);
-        
-        int count = countQueueElements(&mlfq_queues[q]);
-        for (int i = 0; i < count; i++) {
-            int pid = dequeue(&mlfq_queues[q]);
-            if (pid > 0) {
-                enqueue(&tempQueue, pid);
-                enqueue(&mlfq_queues[q], pid);
-            }
+        for (int k = start[q]; k < start[q + 1]; k++) {
+            ProcessInfo *info = &sim_state.processes[by_level[k]];
+            snprintf(text, sizeof(text), "MLFQ Queue %d | PID: %d | Queue: %d",
+                     q, info->pid, q);
+            panel_row(&queue_panel, QUEUE_ROW_KEY(QUEUE_ROW_READY + q, info->pid), info->pid, text);
         }
+    }
 
-        while (!isEmpty(&tempQueue)) {
-            int pid = dequeue(&tempQueue);
-            if (pid <= 0) continue;
-
-            for (int i = 0; i < sim_state.numProcesses; i++) {
-                if (sim_state.processes[i].pid == pid) {
-                    char *display_text = g_strdup_printf(
-                        "MLFQ Queue %d | PID: %d | Time: %d | Queue: %d",
-                        q,
-                        sim_state.processes[i].pid,
-                        sim_state.processes[i].timeInQueue,
-                        q);
-                    GObject *item = G_OBJECT(gtk_string_object_new(display_text));
-                    g_list_store_append(queue_store, item);
-                    g_object_unref(item);
-                    g_free(display_text);
-                    break;
-                }
-            }
-        }
+    Queue *blocked = &sim_state.blockedQueue;
+    for (int pid = queueFirst(blocked); pid > 0; pid = queueNext(blocked, pid)) {
+        ProcessInfo *info = processInfo(pid);
+        if (!info) continue;
+        snprintf(text, sizeof(text), "BLOCKED | PID: %d | Queue: %d",
+                 info->pid, info->priority);
+        panel_row(&queue_panel, QUEUE_ROW_KEY(QUEUE_ROW_BLOCKED, info->pid), info->pid, text);
     }
+    panel_end(&queue_panel);
+}
 
-    if (!isEmpty(&sim_state.blockedQueue)) {
-        Queue tempQueue;
-        initializeQueue(&tempQueue);
-        
-        int count = countQueueElements(&sim_state.blockedQueue);
-        for (int i = 0; i < count; i++) {
-            int pid = dequeue(&sim_state.blockedQueue);
-            if (pid > 0) {
-                enqueue(&tempQueue, pid);
-                enqueue(&sim_state.blockedQueue, pid);
-            }
-        }
+// Time labels of the rows on screen; only these are refreshed every frame
+static GHashTable *time_labels = NULL;
 
-        while (!isEmpty(&tempQueue)) {
-            int pid = dequeue(&tempQueue);
-            if (pid <= 0) continue;
-
-            for (int i = 0; i < sim_state.numProcesses; i++) {
-                if (sim_state.processes[i].pid == pid) {
-                    char *display_text = g_strdup_printf(
-                        "BLOCKED | PID: %d | Time: %d | Queue: %d",
-                        sim_state.processes[i].pid,
-                        sim_state.processes[i].timeInQueue,
-                        sim_state.processes[i].priority);
-                    GObject *item = G_OBJECT(gtk_string_object_new(display_text));
-                    g_list_store_append(queue_store, item);
-                    g_object_unref(item);
-                    g_free(display_text);
-                    break;
-                }
-            }
-        }
+static void set_time_label(GtkWidget *time_label) {
+    char text[32];
+    ProcessInfo *info = processInfo(GPOINTER_TO_INT(g_object_get_data(G_OBJECT(time_label), "pid")));
+    snprintf(text, sizeof(text), "| Time in Queue: %d", info ? info->timeInQueue : 0);
+    gtk_label_set_text(GTK_LABEL(time_label), text);
+}
+
+static void update_time_labels(void) {
+    if (time_labels == NULL) return;
+    GHashTableIter iter;
+    gpointer time_label;
+    g_hash_table_iter_init(&iter, time_labels);
+    while (g_hash_table_iter_next(&iter, &time_label, NULL)) {
+        set_time_label(time_label);
     }
 }
 
 static void setup_list_item(GtkListItemFactory *factory, GtkListItem *item, gpointer user_data) {
+    GtkWidget *row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
     GtkWidget *label = gtk_label_new(NULL);
     gtk_label_set_xalign(GTK_LABEL(label), 0);
     gtk_label_set_wrap(GTK_LABEL(label), TRUE);
-    gtk_list_item_set_child(item, label);
+    gtk_box_append(GTK_BOX(row), label);
+    gtk_box_append(GTK_BOX(row), gtk_label_new(NULL));
+    gtk_list_item_set_child(item, row);
 }
 
 static void bind_list_item(GtkListItemFactory *factory, GtkListItem *item, gpointer user_data) {
-    GtkWidget *label = gtk_list_item_get_child(item);
+    GtkWidget *row = gtk_list_item_get_child(item);
+    GtkWidget *label = gtk_widget_get_first_child(row);
+    GtkWidget *time_label = gtk_widget_get_last_child(row);
     GtkStringObject *string_obj = gtk_list_item_get_item(item);
     if (string_obj) {
         const char *text = gtk_string_object_get_string(string_obj);
         gtk_label_set_text(GTK_LABEL(label), text);
+        g_object_set_data(G_OBJECT(time_label), "pid", g_object_get_data(G_OBJECT(string_obj), "pid"));
+        if (time_labels == NULL) time_labels = g_hash_table_new(NULL, NULL);
+        g_hash_table_add(time_labels, time_label);
+        set_time_label(time_label);
     }
 }
 
+static void unbind_list_item(GtkListItemFactory *factory, GtkListItem *item, gpointer user_data) {
+    GtkWidget *row = gtk_list_item_get_child(item);
+    if (time_labels) g_hash_table_remove(time_labels, gtk_widget_get_last_child(row));
+}
+
 static void update_mutex_grid() {
     for (int i = 0; i < 3; i++) {
         GtkWidget *status_label = gtk_grid_get_child_at(GTK_GRID(mutex_grid), 1, i + 1);
@@ -263,11 +401,16 @@ static void update_mutex_grid() {
     }
 }
 
-void update_overview() {
+static void update_overview() {
     int used_memory = 0;
-    for (int i = 0; i < sim_state.numProcesses; i++) {
-        if (strcmp(sim_state.processes[i].state, "Terminated") != 0) {
-            used_memory += (sim_state.processes[i].upperBound - sim_state.processes[i].lowerBound + 1);
+    if (paging_enabled()) {
+        // Frames in use, plus any words too few to make a whole frame
+        used_memory = limits.memorySize - paging_free_words();
+    } else {
+        for (int i = 0; i < sim_state.numProcesses; i++) {
+            if (sim_state.processes[i].state != TERMINATED && sim_state.processes[i].lowerBound >= 0) {
+                used_memory += (sim_state.processes[i].upperBound - sim_state.processes[i].lowerBound + 1);
+            }
         }
     }
 
@@ -277,34 +420,39 @@ void update_overview() {
              sim_state.numProcesses, 
              sim_state.clockCycle, 
              sim_state.schedulerType,
-             MEMORY_SIZE - used_memory);
+             limits.memorySize - used_memory);
     gtk_label_set_text(GTK_LABEL(overview_label), overview);
 }
 
-static void update_memory_grid_viewer() {
-    if (!memory_grid_viewer) return;
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        int col = i / 20;
-        int row = i % 20;
-        GtkWidget *label = gtk_grid_get_child_at(GTK_GRID(memory_grid_viewer), col, row);
-        if (!label) continue;
-        char display[192];
-        snprintf(display, sizeof(display), "<span foreground='#569cd6' weight='bold'>%d:</span> %s", i, sim_state.memory[i][0] ? sim_state.memory[i] : "Empty");
-        gtk_label_set_markup(GTK_LABEL(label), display);
+// Words copied by sync_memory_view; the grid view rebinds them if they are visible
+static void memory_words_changed(int first, int count) {
+    if (memory_model) {
+        g_list_model_items_changed(G_LIST_MODEL(memory_model), first, count, count);
     }
 }
 
-static gboolean update_gui_idle(gpointer user_data) {
-    update_overview();
-    update_process_list();
-    update_queue_list();
-    update_mutex_grid();
-    update_memory_grid_viewer();
+// Runs on the next frame clock tick; all updates since the last frame share it
+static gboolean update_gui_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data) {
+    unsigned dirty = sim_state.dirty;
+    sim_state.dirty = 0;
+    gui_tick_id = 0;
+
+    if (dirty & (DIRTY_PROCESSES | DIRTY_QUEUES)) sync_queue_view(&sim_state);
+    if (dirty & DIRTY_OVERVIEW) update_overview();
+    if (dirty & DIRTY_PROCESSES) update_process_list();
+    if (dirty & DIRTY_QUEUES) update_queue_list();
+    if (dirty & (DIRTY_PROCESSES | DIRTY_QUEUES)) update_time_labels();
+    if (dirty & DIRTY_MUTEXES) update_mutex_grid();
+    if (dirty & DIRTY_MEMORY) {
+        sync_memory_view(&sim_state, memory_words_changed);
+    }
     return G_SOURCE_REMOVE;
 }
 
 void update_gui(SimulationState *state) {
-    g_idle_add(update_gui_idle, NULL);
+    if (gui_tick_id == 0 && window != NULL) {
+        gui_tick_id = gtk_widget_add_tick_callback(window, update_gui_tick, NULL, NULL);
+    }
 }
 
 static void on_scheduler_changed(GtkDropDown *dropdown, gpointer user_data) {
@@ -312,12 +460,12 @@ static void on_scheduler_changed(GtkDropDown *dropdown, gpointer user_data) {
     const char *text = gtk_string_object_get_string(selected);
     strncpy(sim_state.schedulerType, text, sizeof(sim_state.schedulerType) - 1);
     sim_state.schedulerType[sizeof(sim_state.schedulerType) - 1] = '\0';
-    append_log(&sim_state, g_strdup_printf("Scheduler changed to %s", sim_state.schedulerType));
+    append_logf(&sim_state, "Scheduler changed to %s", sim_state.schedulerType);
 }
 
 static void on_quantum_changed(GtkSpinButton *spin, gpointer user_data) {
     sim_state.rrQuantum = gtk_spin_button_get_value_as_int(spin);
-    append_log(&sim_state, g_strdup_printf("Round-Robin quantum set to %d", sim_state.rrQuantum));
+    append_logf(&sim_state, "Round-Robin quantum set to %d", sim_state.rrQuantum);
 }
 
 static void on_start_clicked(GtkButton *button, gpointer user_data) {
@@ -347,6 +495,10 @@ static int parse_command(const char *input) {
     return OTHER_COMMAND;
 }
 
+static void on_compact_clicked(GtkButton *button, gpointer user_data) {
+    compactMemory();
+}
+
 static void on_step_clicked(GtkButton *button, gpointer user_data) {
     run_simulation_cycle(&sim_state);
     update_gui(&sim_state);
@@ -359,15 +511,14 @@ static gboolean run_simulation_cycle_idle(gpointer user_data) {
     if (sim_state.waiting_for_input_pid > 0) {
         auto_timer_id = 0;
         gtk_button_set_label(GTK_BUTTON(auto_button), "Auto Execute");
-        append_log(&sim_state, g_strdup_printf("Paused for input for PID %d, variable %s",
-                                               sim_state.waiting_for_input_pid,
-                                               sim_state.waiting_for_input_var));
+        append_logf(&sim_state, "Paused for input for PID %d, variable %s",
+                    sim_state.waiting_for_input_pid, sim_state.waiting_for_input_var);
         return G_SOURCE_REMOVE;
     }
 
     int all_finished = 1;
     for (int i = 0; i < sim_state.numProcesses; i++) {
-        if (strcmp(sim_state.processes[i].state, "Terminated") != 0) {
+        if (sim_state.processes[i].state != TERMINATED) {
             all_finished = 0;
             break;
         }
@@ -414,7 +565,7 @@ static void on_file_dialog_response(GObject *source_object, GAsyncResult *result
         char *filename = g_file_get_path(file);
         int arrival = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(arrival_spin));
         add_process(&sim_state, filename, arrival);
-        append_log(&sim_state, g_strdup_printf("Added process from %s with arrival time %d", filename, arrival));
+        append_logf(&sim_state, "Added process from %s with arrival time %d", filename, arrival);
         g_free(filename);
         g_object_unref(file);
     }
@@ -440,7 +591,7 @@ static void on_log_entry_activate(GtkEntry *entry, gpointer user_data) {
             int pid = sim_state.waiting_for_input_pid;
             const char *var = sim_state.waiting_for_input_var;
             updateVariable(pid, var, input);
-            append_log(&sim_state, g_strdup_printf("PID %d: Assigned %s = %s (from GUI input)", pid, var, input));
+            append_logf(&sim_state, "PID %d: Assigned %s = %s (from GUI input)", pid, var, input);
             sim_state.waiting_for_input_pid = 0;
             sim_state.waiting_for_input_var[0] = '\0';
             if (auto_execution_active && auto_timer_id == 0) {
@@ -503,6 +654,26 @@ static void setup_theme() {
     g_object_unref(provider);
 }
 
+static void setup_memory_cell(GtkListItemFactory *factory, GtkListItem *item, gpointer user_data) {
+    GtkWidget *label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(label), 0);
+    gtk_widget_add_css_class(label, "memory-cell");
+    gtk_widget_set_hexpand(label, TRUE);
+    gtk_list_item_set_child(item, label);
+}
+
+static void bind_memory_cell(GtkListItemFactory *factory, GtkListItem *item, gpointer user_data) {
+    GtkWidget *label = gtk_list_item_get_child(item);
+    MemoryWord *word = gtk_list_item_get_item(item);
+    if (!word) return;
+    // The view copy is made by the first sync_memory_view; until then show words as empty
+    const char *text = sim_state.memory ? sim_state.memory[word->address] : "";
+    char *display = g_markup_printf_escaped("<span foreground='#569cd6' weight='bold'>%d:</span> %s",
+                                            word->address, text[0] ? text : "Empty");
+    gtk_label_set_markup(GTK_LABEL(label), display);
+    g_free(display);
+}
+
 static void setup_memory_grid_viewer(GtkWidget *container) {
     GtkWidget *frame = gtk_frame_new("Memory Viewer");
     gtk_box_append(GTK_BOX(container), frame);
@@ -512,26 +683,19 @@ static void setup_memory_grid_viewer(GtkWidget *container) {
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
     gtk_frame_set_child(GTK_FRAME(frame), scroll);
 
-    memory_grid_viewer = gtk_grid_new();
-    gtk_grid_set_column_spacing(GTK_GRID(memory_grid_viewer), 8);
-    gtk_grid_set_row_spacing(GTK_GRID(memory_grid_viewer), 4);
-    gtk_widget_set_hexpand(memory_grid_viewer, TRUE);
-    gtk_widget_set_vexpand(memory_grid_viewer, TRUE);
-
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        int col = i / 20;
-        int row = i % 20;
-        char display[192];
-        snprintf(display, sizeof(display), "<span foreground='#569cd6' weight='bold'>%d:</span> %s", i, sim_state.memory[i][0] ? sim_state.memory[i] : "Empty");
-        GtkWidget *label = gtk_label_new(NULL);
-        gtk_label_set_xalign(GTK_LABEL(label), 0);
-        gtk_label_set_markup(GTK_LABEL(label), display);
-        gtk_widget_add_css_class(label, "memory-cell");
-        gtk_widget_set_hexpand(label, TRUE);
-        gtk_widget_set_vexpand(label, FALSE);
-        gtk_grid_attach(GTK_GRID(memory_grid_viewer), label, col, row, 1, 1);
-    }
-    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroll), memory_grid_viewer);
+    memory_model = g_object_new(MEMORY_TYPE_MODEL, NULL);
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(setup_memory_cell), NULL);
+    g_signal_connect(factory, "bind", G_CALLBACK(bind_memory_cell), NULL);
+
+    // The selection model takes the first reference; memory_model stays valid with the view
+    GtkSelectionModel *selection = GTK_SELECTION_MODEL(gtk_no_selection_new(G_LIST_MODEL(memory_model)));
+    GtkWidget *grid_view = gtk_grid_view_new(selection, factory);
+    gtk_grid_view_set_min_columns(GTK_GRID_VIEW(grid_view), 3);
+    gtk_grid_view_set_max_columns(GTK_GRID_VIEW(grid_view), 3);
+    gtk_widget_set_hexpand(grid_view, TRUE);
+    gtk_widget_set_vexpand(grid_view, TRUE);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroll), grid_view);
 }
 
 static void setup_gui(GtkApplication *app, gpointer user_data) {
@@ -590,12 +754,13 @@ static void setup_gui(GtkApplication *app, gpointer user_data) {
     gtk_grid_attach(GTK_GRID(process_header), gtk_label_new("Time in Queue"), 5, 0, 1, 1);
     gtk_box_append(GTK_BOX(process_box), process_header);
 
-    process_store = g_list_store_new(GTK_TYPE_STRING_OBJECT);
-    GtkSelectionModel *process_selection = GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(process_store)));
+    init_list_panel(&process_panel);
+    GtkSelectionModel *process_selection = GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(process_panel.store)));
     
     GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
     g_signal_connect(factory, "setup", G_CALLBACK(setup_list_item), NULL);
     g_signal_connect(factory, "bind", G_CALLBACK(bind_list_item), NULL);
+    g_signal_connect(factory, "unbind", G_CALLBACK(unbind_list_item), NULL);
     
     process_list_view = gtk_list_view_new(process_selection, factory);
     GtkWidget *process_scroll = gtk_scrolled_window_new();
@@ -612,16 +777,17 @@ static void setup_gui(GtkApplication *app, gpointer user_data) {
     gtk_grid_set_column_spacing(GTK_GRID(queue_header), 5);
     gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("Queue Type"), 0, 0, 1, 1);
     gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("PID"), 1, 0, 1, 1);
-    gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("Time in Queue"), 2, 0, 1, 1);
-    gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("Priority"), 3, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("Priority"), 2, 0, 1, 1);
+    gtk_grid_attach(GTK_GRID(queue_header), gtk_label_new("Time in Queue"), 3, 0, 1, 1);
     gtk_box_append(GTK_BOX(queue_box), queue_header);
 
-    queue_store = g_list_store_new(GTK_TYPE_STRING_OBJECT);
-    GtkSelectionModel *queue_selection = GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(queue_store)));
+    init_list_panel(&queue_panel);
+    GtkSelectionModel *queue_selection = GTK_SELECTION_MODEL(gtk_single_selection_new(G_LIST_MODEL(queue_panel.store)));
     
     GtkListItemFactory *queue_factory = gtk_signal_list_item_factory_new();
     g_signal_connect(queue_factory, "setup", G_CALLBACK(setup_list_item), NULL);
     g_signal_connect(queue_factory, "bind", G_CALLBACK(bind_list_item), NULL);
+    g_signal_connect(queue_factory, "unbind", G_CALLBACK(unbind_list_item), NULL);
     
     queue_list_view = gtk_list_view_new(queue_selection, queue_factory);
     GtkWidget *queue_scroll = gtk_scrolled_window_new();
@@ -716,6 +882,9 @@ static void setup_gui(GtkApplication *app, gpointer user_data) {
     gtk_box_append(GTK_BOX(process_control_box), arrival_spin);
     gtk_box_append(GTK_BOX(process_control_box), add_process_button);
     g_signal_connect(add_process_button, "clicked", G_CALLBACK(on_add_process_clicked), NULL);
+    compact_button = gtk_button_new_with_label("Compact Memory");
+    gtk_box_append(GTK_BOX(process_control_box), compact_button);
+    g_signal_connect(compact_button, "clicked", G_CALLBACK(on_compact_clicked), NULL);
     gtk_box_append(GTK_BOX(control_box), process_control_box);
 
     gtk_box_append(GTK_BOX(right_top), control_frame);
@@ -756,6 +925,7 @@ static void setup_gui(GtkApplication *app, gpointer user_data) {
     gtk_widget_set_vexpand(log_frame, TRUE);
 
     gtk_window_present(GTK_WINDOW(window));
+    mark_dirty(&sim_state, DIRTY_ALL);
 }
 
 void init_gui(int argc, char *argv[]) {
@@ -3,19 +3,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include "instruction.h"
+#include "arena.h"
 
-/*Instruction* create_instruction(InstructionType type, char arg1[], char arg2[]) {
-    Instruction* instruction = (Instruction*)malloc(sizeof(Instruction));
-    if (instruction == NULL) {
-        printf("memory error for Instruction\n");
-        return NULL;
-    }
-    instruction->type = type;
-    strcpy(instruction->arg1, arg1);
-    strcpy(instruction->arg2, arg2);
-
-    return instruction;
-}*/
+// Mutex names in the order of SimulationState.mutexes
+static const char* mutexNames[] = {"userInput", "file", "userOutput"};
 
 InstructionType getInstructionType(const char* command) {
     if (strcmp(command, "print") == 0) return PRINT;
@@ -26,4 +17,188 @@ InstructionType getInstructionType(const char* command) {
     if (strcmp(command, "semWait") == 0) return SEM_WAIT;
     if (strcmp(command, "semSignal") == 0) return SEM_SIGNAL;
     return INVALID;
+}
+
+typedef struct {
+    int offset;
+    int length;
+} Token;
+
+static int tokenize(const char* line, Token tokens[], int maxTokens) {
+    int count = 0;
+    int i = 0;
+    while (line[i] && count < maxTokens) {
+        while (line[i] == ' ' || line[i] == '\t' || line[i] == '\r') i++;
+        if (!line[i]) break;
+        tokens[count].offset = i;
+        while (line[i] && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') i++;
+        tokens[count].length = i - tokens[count].offset;
+        count++;
+    }
+    return count;
+}
+
+static bool tokenIs(const char* line, Token token, const char* word) {
+    return token.length == (int)strlen(word) && strncmp(line + token.offset, word, token.length) == 0;
+}
+
+// Variables get slots in order of their first assignment in the program text.
+// Names go in an open-addressing table sized for every assign line, so it
+// never fills and a program can have any number of variables.
+typedef struct {
+    const char* name;
+    int length;
+    int slot; // -1 for an empty bucket
+} Symbol;
+
+typedef struct {
+    Symbol* buckets;
+    unsigned int mask;
+    int count;
+} SymbolTable;
+
+static unsigned int hashName(const char* name, int length) {
+    unsigned int hash = 2166136261u; // FNV-1a
+    for (int i = 0; i < length; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static Symbol* findBucket(const SymbolTable* symbols, const char* name, int length) {
+    unsigned int i = hashName(name, length) & symbols->mask;
+    while (symbols->buckets[i].slot != -1 &&
+           (symbols->buckets[i].length != length || strncmp(symbols->buckets[i].name, name, length) != 0)) {
+        i = (i + 1) & symbols->mask;
+    }
+    return &symbols->buckets[i];
+}
+
+static int lookupSymbol(const SymbolTable* symbols, const char* name, int length) {
+    return findBucket(symbols, name, length)->slot;
+}
+
+static void defineSymbol(SymbolTable* symbols, const char* name, int length) {
+    Symbol* symbol = findBucket(symbols, name, length);
+    if (symbol->slot != -1) return;
+    symbol->name = name;
+    symbol->length = length;
+    symbol->slot = symbols->count++;
+}
+
+static void setOperand(Operand* op, OperandKind kind, Token token) {
+    op->kind = kind;
+    op->slot = -1;
+    op->offset = token.offset;
+    op->length = token.length;
+    op->isNumber = false;
+    op->number = 0;
+}
+
+// A name is a variable if the program assigns it; anything else is a literal
+static void decodeValueOperand(Operand* op, const char* line, Token token, const SymbolTable* symbols) {
+    int slot = lookupSymbol(symbols, line + token.offset, token.length);
+    if (slot != -1) {
+        setOperand(op, OPERAND_VARIABLE, token);
+        op->slot = slot;
+        return;
+    }
+    setOperand(op, OPERAND_LITERAL, token);
+    char* end;
+    long value = strtol(line + token.offset, &end, 10);
+    if (end != line + token.offset) {
+        op->isNumber = true;
+        op->number = (int)value;
+    }
+}
+
+static void decodeInstruction(const char* line, Instruction* ins, const SymbolTable* symbols) {
+    Token tokens[4];
+    int count = tokenize(line, tokens, 4);
+    memset(ins, 0, sizeof(*ins));
+    ins->mutex = -1;
+    ins->arg1.slot = -1;
+    ins->arg2.slot = -1;
+    if (count == 0) {
+        ins->type = INVALID;
+        return;
+    }
+
+    char command[MAX_INSTRUCTION_LENGTH];
+    snprintf(command, sizeof(command), "%.*s", tokens[0].length, line + tokens[0].offset);
+    ins->type = getInstructionType(command);
+    // Invalid instructions report their command word
+    setOperand(&ins->arg1, OPERAND_NONE, tokens[0]);
+    if (ins->type == INVALID || count < 2) return;
+
+    switch (ins->type) {
+        case SEM_WAIT:
+        case SEM_SIGNAL:
+            setOperand(&ins->arg1, OPERAND_LITERAL, tokens[1]);
+            for (int i = 0; i < 3; i++) {
+                if (tokenIs(line, tokens[1], mutexNames[i])) ins->mutex = i;
+            }
+            break;
+
+        case ASSIGN:
+            setOperand(&ins->arg1, OPERAND_VARIABLE, tokens[1]);
+            ins->arg1.slot = lookupSymbol(symbols, line + tokens[1].offset, tokens[1].length);
+            if (count < 3) break;
+            if (tokenIs(line, tokens[2], "input")) {
+                setOperand(&ins->arg2, OPERAND_INPUT, tokens[2]);
+            } else if (tokenIs(line, tokens[2], "readFile") && count >= 4) {
+                setOperand(&ins->arg2, OPERAND_READ_FILE, tokens[3]);
+                ins->arg2.slot = lookupSymbol(symbols, line + tokens[3].offset, tokens[3].length);
+            } else {
+                setOperand(&ins->arg2, OPERAND_LITERAL, tokens[2]);
+            }
+            break;
+
+        default:
+            decodeValueOperand(&ins->arg1, line, tokens[1], symbols);
+            if (count >= 3) decodeValueOperand(&ins->arg2, line, tokens[2], symbols);
+            break;
+    }
+}
+
+// Decode a loaded program in place; lines and out are parallel arrays
+int decodeProgram(char lines[][MAX_LINE_LENGTH], int count, Instruction* out) {
+    // Twice as many buckets as lines keeps the probe sequences short
+    SymbolTable symbols = {NULL, 1, 0};
+    while (symbols.mask < 2u * count) symbols.mask <<= 1;
+    ArenaMark scratch = arena_mark();
+    symbols.buckets = arena_alloc(symbols.mask * sizeof(Symbol));
+    if (symbols.buckets == NULL) {
+        printf("memory error for a symbol table of %u entries\n", symbols.mask);
+        return -1;
+    }
+    for (unsigned int i = 0; i < symbols.mask; i++) {
+        symbols.buckets[i].slot = -1;
+    }
+    symbols.mask--;
+
+    for (int i = 0; i < count; i++) {
+        Token tokens[2];
+        if (tokenize(lines[i], tokens, 2) == 2 && tokenIs(lines[i], tokens[0], "assign")) {
+            defineSymbol(&symbols, lines[i] + tokens[1].offset, tokens[1].length);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        decodeInstruction(lines[i], &out[i], &symbols);
+    }
+    arena_release(scratch);
+    return symbols.count;
+}
+
+// Resolve a variable name to its slot using the program's assignments
+int findVariableSlot(const Instruction* code, char lines[][MAX_LINE_LENGTH], int count, const char* name) {
+    int length = strlen(name);
+    for (int i = 0; i < count; i++) {
+        const Operand* op = &code[i].arg1;
+        if (code[i].type == ASSIGN && op->length == length &&
+            strncmp(lines[i] + op->offset, name, length) == 0) {
+            return op->slot;
+        }
+    }
+    return -1;
 }
\ No newline at end of file
@@ -2,9 +2,12 @@
 #ifndef INSTRUCTION_H
 #define INSTRUCTION_H
 
+#include <stdbool.h>
+#include "pcb.h"
 
 #define MAX_INSTRUCTION_LENGTH 100
 #define MAX_PROGRAM_LINES 50
+#define MIN_VARIABLE_WORDS 3 // Variable words at the top of each process image, more if the program has more variables
 
 typedef enum {
     PRINT,
@@ -17,13 +20,41 @@ typedef enum {
     INVALID
 } InstructionType;
 
+typedef enum {
+    OPERAND_NONE,
+    OPERAND_VARIABLE,  // One of the process's variable slots
+    OPERAND_LITERAL,   // Text taken verbatim from the source line (or a stored value, see below)
+    OPERAND_INPUT,     // "input": value typed by the user
+    OPERAND_READ_FILE  // "readFile x": last line of the file named by variable x
+} OperandKind;
+
+// Operand text is kept as an offset/length into the instruction's source line,
+// which stays in memory next to the decoded record.
+//
+// A variable word ("name : value") uses its decoded arg1 as the typed value:
+// OPERAND_NONE until assigned, then OPERAND_LITERAL with offset/length giving
+// the value inside the word and isNumber/number its numeric reading.
+typedef struct {
+    unsigned char kind;
+    unsigned char offset;
+    unsigned char length;
+    bool isNumber;
+    int slot;              // Variable slot for OPERAND_VARIABLE/OPERAND_READ_FILE, -1 if unknown
+    int number;            // Value of a numeric literal
+} Operand;
+
 typedef struct {
     InstructionType type;
-    char arg1[50];
-    char arg2[50];
+    signed char mutex;     // Mutex index for SEM_WAIT/SEM_SIGNAL, -1 if unknown
+    Operand arg1;
+    Operand arg2;
 } Instruction;
 
-/*Instruction* create_instruction(InstructionType type, char arg1[], char arg2[]);*/
+// Decoded image of memory, filled by loadProgram alongside the text
+extern Instruction* decoded; // Parallel to memory, limits.memorySize entries
+
 InstructionType getInstructionType(const char* command);
+int decodeProgram(char lines[][MAX_LINE_LENGTH], int count, Instruction* out); // Variables used, -1 on error
+int findVariableSlot(const Instruction* code, char lines[][MAX_LINE_LENGTH], int count, const char* name);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include <stdio.h>
+#include <string.h>
+#include "log.h"
+
+static _Thread_local void (*stdoutCapture)(const char* text) = NULL;
+
+// Conversion spec as found in a format string: "%-5.*s" and the like
+typedef struct {
+    const char* begin;
+    int length;    // Characters from '%' up to and including the conversion
+    int stars;     // Width/precision taken from the argument list
+    int widthStar; // "%*s": the first star is the width
+    int precisionStar; // "%.*s": the last star is the precision
+    int precision; // Literal precision, -1 when absent or '*'
+    int longs;     // Number of 'l' modifiers, 'z' counts as one
+    char conversion;
+} FormatSpec;
+
+static const char* parseSpec(const char* p, FormatSpec* spec) {
+    spec->begin = p++;
+    spec->stars = 0;
+    spec->widthStar = 0;
+    spec->precisionStar = 0;
+    spec->precision = -1;
+    spec->longs = 0;
+    while (*p && strchr("-+ #0", *p)) p++;
+    if (*p == '*') {
+        spec->stars++;
+        spec->widthStar = 1;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            spec->precisionStar = 1;
+            p++;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') spec->precision = spec->precision * 10 + (*p++ - '0');
+        }
+    }
+    while (*p == 'h') p++;
+    while (*p == 'l' || *p == 'z') {
+        spec->longs++;
+        p++;
+    }
+    spec->conversion = *p;
+    if (*p) p++;
+    spec->length = (int)(p - spec->begin);
+    return p;
+}
+
+static int capture(LogRecord* record, const void* value, size_t size) {
+    if (record->argBytes + size > LOG_ARG_BYTES) return 0;
+    memcpy(record->args + record->argBytes, value, size);
+    record->argBytes += size;
+    return 1;
+}
+
+// Copy a string argument, truncated to what is left of the record
+static int captureString(LogRecord* record, const char* s, int precision) {
+    if (s == NULL) s = "(null)";
+    size_t room = LOG_ARG_BYTES - record->argBytes;
+    if (room == 0) return 0;
+    size_t length = precision >= 0 ? strnlen(s, precision) : strlen(s);
+    if (length > room - 1) length = room - 1;
+    memcpy(record->args + record->argBytes, s, length);
+    record->args[record->argBytes + length] = '\0';
+    record->argBytes += length + 1;
+    return 1;
+}
+
+void log_capture(LogRecord* record, int cycle, int pid, const char* format, va_list args) {
+    record->cycle = cycle;
+    record->pid = pid;
+    record->format = format;
+    record->argBytes = 0;
+
+    int full = 0;
+    for (const char* p = format; *p && !full; ) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            p += 2;
+            continue;
+        }
+        FormatSpec spec;
+        p = parseSpec(p, &spec);
+        int precision = spec.precision;
+        for (int i = 0; i < spec.stars && !full; i++) {
+            int star = va_arg(args, int);
+            if (spec.precisionStar && i == spec.stars - 1) precision = star;
+            full = !capture(record, &star, sizeof(star));
+        }
+        if (full) break;
+        switch (spec.conversion) {
+            case 's':
+                full = !captureString(record, va_arg(args, const char*), precision);
+                break;
+            case 'f': case 'e': case 'g': {
+                double value = va_arg(args, double);
+                full = !capture(record, &value, sizeof(value));
+                break;
+            }
+            case 'p': {
+                void* value = va_arg(args, void*);
+                full = !capture(record, &value, sizeof(value));
+                break;
+            }
+            default:
+                if (spec.longs > 0) {
+                    long long value = spec.longs > 1 ? va_arg(args, long long) : va_arg(args, long);
+                    full = !capture(record, &value, sizeof(value));
+                } else {
+                    int value = va_arg(args, int);
+                    full = !capture(record, &value, sizeof(value));
+                }
+                break;
+        }
+    }
+}
+
+void log_record(EventLog* log, int cycle, int pid, const char* format, va_list args) {
+    log_capture(&log->records[log->next % LOG_CAPACITY], cycle, pid, format, args);
+    log->next++;
+}
+
+void log_append(EventLog* log, const LogRecord* record) {
+    LogRecord* slot = &log->records[log->next % LOG_CAPACITY];
+    memcpy(slot, record, offsetof(LogRecord, args) + record->argBytes);
+    log->next++;
+}
+
+void log_clear(EventLog* log) {
+    log->start = log->next;
+}
+
+unsigned long log_oldest(const EventLog* log) {
+    unsigned long oldest = log->next > LOG_CAPACITY ? log->next - LOG_CAPACITY : 0;
+    return oldest > log->start ? oldest : log->start;
+}
+
+const LogRecord* log_get(const EventLog* log, unsigned long seq) {
+    if (seq < log_oldest(log) || seq >= log->next) return NULL;
+    return &log->records[seq % LOG_CAPACITY];
+}
+
+// Append to out like snprintf, keeping track of the full length
+static void put(char* out, size_t size, size_t* pos, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(*pos < size ? out + *pos : NULL, *pos < size ? size - *pos : 0, format, args);
+    va_end(args);
+    if (written > 0) *pos += written;
+}
+
+static int take(const LogRecord* record, size_t* offset, void* value, size_t size) {
+    if (*offset + size > record->argBytes) return 0;
+    memcpy(value, record->args + *offset, size);
+    *offset += size;
+    return 1;
+}
+
+int log_format(const LogRecord* record, char* out, size_t size) {
+    size_t pos = 0;
+    size_t offset = 0;
+    if (size > 0) out[0] = '\0';
+    if (record->pid > 0) {
+        put(out, size, &pos, "[Cycle %d] [PID %d] ", record->cycle, record->pid);
+    }
+
+    const char* p = record->format;
+    while (*p) {
+        const char* literal = p;
+        while (*p && (*p != '%' || p[1] == '%')) p += (*p == '%') ? 2 : 1;
+        for (const char* c = literal; c < p; c++) {
+            if (*c == '%') c++;
+            put(out, size, &pos, "%c", *c);
+        }
+        if (!*p) break;
+
+        FormatSpec spec;
+        p = parseSpec(p, &spec);
+        char conversion[16];
+        snprintf(conversion, sizeof(conversion), "%.*s", spec.length, spec.begin);
+        int stars[2] = {0, 0};
+        int ok = 1;
+        for (int i = 0; i < spec.stars && i < 2; i++) {
+            ok = ok && take(record, &offset, &stars[i], sizeof(int));
+        }
+
+        if (ok && spec.conversion == 's') {
+            if (offset >= record->argBytes) {
+                ok = 0;
+            } else {
+                const char* s = (const char*)record->args + offset;
+                offset += strlen(s) + 1;
+                if (spec.stars == 2) put(out, size, &pos, conversion, stars[0], stars[1], s);
+                else if (spec.stars == 1) put(out, size, &pos, conversion, stars[0], s);
+                else put(out, size, &pos, conversion, s);
+            }
+        } else if (ok && spec.conversion && strchr("feg", spec.conversion)) {
+            double value;
+            ok = take(record, &offset, &value, sizeof(value));
+            if (ok) put(out, size, &pos, conversion, value);
+        } else if (ok && spec.conversion == 'p') {
+            void* value;
+            ok = take(record, &offset, &value, sizeof(value));
+            if (ok) put(out, size, &pos, conversion, value);
+        } else if (ok && spec.longs > 0) {
+            long long value;
+            ok = take(record, &offset, &value, sizeof(value));
+            if (ok) {
+                // Captured as long long whatever the modifier was
+                int modifier = (int)strcspn(conversion, "lz");
+                snprintf(conversion + modifier, sizeof(conversion) - modifier, "ll%c", spec.conversion);
+                put(out, size, &pos, conversion, value);
+            }
+        } else if (ok) {
+            int value;
+            ok = take(record, &offset, &value, sizeof(value));
+            if (ok) {
+                if (spec.stars == 2) put(out, size, &pos, conversion, stars[0], stars[1], value);
+                else if (spec.stars == 1) put(out, size, &pos, conversion, stars[0], value);
+                else put(out, size, &pos, conversion, value);
+            }
+        }
+        if (!ok) put(out, size, &pos, "?"); // Argument did not fit in the record
+    }
+    return (int)pos;
+}
+
+void log_export(const EventLog* log, FILE* out) {
+    char line[1024];
+    for (unsigned long seq = log_oldest(log); seq < log->next; seq++) {
+        log_format(log_get(log, seq), line, sizeof(line));
+        fprintf(out, "%s\n", line);
+    }
+}
+
+void log_capture_stdout(void (*capture)(const char* text)) {
+    stdoutCapture = capture;
+}
+
+void log_printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (stdoutCapture == NULL) {
+        vprintf(format, args);
+    } else {
+        char text[LOG_ARG_BYTES];
+        vsnprintf(text, sizeof(text), format, args);
+        stdoutCapture(text);
+    }
+    va_end(args);
+}
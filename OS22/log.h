@@ -0,0 +1,47 @@
+// log.h
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define LOG_CAPACITY 4096 // Records kept; the oldest is overwritten when full
+#define LOG_ARG_BYTES 240 // Captured arguments per record (ints and string copies)
+
+// One log event. The format string literal passed to append_logf doubles as the
+// event code; its arguments are captured in binary and only turned into text
+// when a log view or an export asks for the record.
+typedef struct {
+    int cycle;
+    int pid; // Running PID when the event was logged, 0 for none
+    const char* format;
+    unsigned short argBytes;
+    unsigned char args[LOG_ARG_BYTES];
+} LogRecord;
+
+// Fixed-capacity ring of records. 'next' counts every record ever logged, so
+// readers can remember a position and later fetch only what is new.
+typedef struct {
+    LogRecord records[LOG_CAPACITY];
+    unsigned long next;  // Sequence number of the next record
+    unsigned long start; // First sequence number still wanted (moved by log_clear)
+} EventLog;
+
+void log_record(EventLog* log, int cycle, int pid, const char* format, va_list args);
+// Fill a record without logging it, for events staged away from the log
+void log_capture(LogRecord* record, int cycle, int pid, const char* format, va_list args);
+void log_append(EventLog* log, const LogRecord* record); // Log a captured record
+void log_clear(EventLog* log);
+unsigned long log_oldest(const EventLog* log); // Oldest sequence number still held
+const LogRecord* log_get(const EventLog* log, unsigned long seq); // NULL once overwritten
+int log_format(const LogRecord* record, char* out, size_t size);
+void log_export(const EventLog* log, FILE* out);
+
+// printf for warnings from code a core step runs, such as the queues. A thread
+// stepping a core in parallel sets a capture for the calling thread, which
+// keeps the text until the step is merged; NULL prints again.
+void log_printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+void log_capture_stdout(void (*capture)(const char* text));
+
+#endif
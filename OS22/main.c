@@ -2,36 +2,120 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
-#include "pcb.h"
+#include <stdarg.h>
+#include "main.h"
 #include "instruction.h"
-#include "queue.h"
-#include "mutex.h"
+#include "alloc.h"
+#include "swap.h"
+#include "paging.h"
+#include "arena.h"
+#include "smp.h"
+#include "workers.h"
+#ifndef HEADLESS
 #include "gui.h"
+#endif
 
 #define CLOCK_CYCLES_PER_INSTRUCTION 1
-#define NUM_QUEUES 4
 #define TIME_QUANTUM_0 1
 #define TIME_QUANTUM_1 2
 #define TIME_QUANTUM_2 4
 #define TIME_QUANTUM_3 8
 #define RR_TIME_QUANTUM 4
-#define MEMORY_SIZE 60
 #define MAX_LINE_LENGTH 100
-#define MAX_CYCLES 100
 #define DEADLOCK_THRESHOLD 5
 #define MAX_DEADLOCK_ATTEMPTS 3
-
-char memory[MEMORY_SIZE][MAX_LINE_LENGTH];
-int availableMemory = MEMORY_SIZE;
-int deadlock_attempts[MAX_PROCESSES] = {0};
-int quantaCount;
+#define COMPACTION_WORDS_PER_CYCLE 16 // Words the compactor copies per clock cycle charged
+
+// Sized from limits by init_simulation
+char (*memory)[MAX_LINE_LENGTH];
+unsigned long long* memoryDirty;
+Instruction* decoded;
+int availableMemory;
+_Thread_local int quantaCount;
 SimulationState sim_state;
-Queue unBlockedQueue;
+_Thread_local Queue unBlockedQueue;
+// Processes that have not arrived yet, keyed by arrival cycle; equal arrivals
+// keep PID (load) order
+static PriorityQueue arrivals;
+
+// Log record or stdout text of a core stepped in parallel, in the order it came
+typedef struct {
+    bool toStdout; // log_printf text, held as a "%s" record
+    LogRecord record;
+} StagedEvent;
+
+// A core stepped on a worker thread keeps its clock, running PID, log records,
+// stdout text and redraw flags here until runSmpCycle merges them in core order
+typedef struct {
+    StagedEvent* events;
+    int count;
+    int capacity;
+    int clock;
+    int runningPid; // -1 until the step sets it: records then take the PID left by the core before
+    long instructions;
+    unsigned dirty;
+} CoreStage;
+
+static CoreStage* stages = NULL; // One per core
+static _Thread_local CoreStage* stage = NULL; // Set while this thread steps a core in parallel
+// What the schedulers advance: sim_state itself, or the stage of a core
+// stepped in parallel
+static _Thread_local int* stepClock = &sim_state.clockCycle;
+static _Thread_local int* stepPid = &sim_state.runningPid;
+static _Thread_local long* stepInstructions = &sim_state.instructionsExecuted;
+
+static int allocateImage(int words, int excludeSlot);
+
+static void stageEvent(bool toStdout, const char *format, va_list args) {
+    if (stage->count == stage->capacity) {
+        int capacity = stage->capacity ? stage->capacity * 2 : 16;
+        StagedEvent* grown = heap_realloc(stage->events, capacity * sizeof(StagedEvent));
+        if (grown == NULL) {
+            printf("memory error for %d staged log records\n", capacity);
+            return;
+        }
+        stage->events = grown;
+        stage->capacity = capacity;
+    }
+    StagedEvent* event = &stage->events[stage->count++];
+    event->toStdout = toStdout;
+    log_capture(&event->record, toStdout ? 0 : stage->clock, toStdout ? 0 : stage->runningPid, format, args);
+}
+
+static void stageText(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    stageEvent(true, format, args);
+    va_end(args);
+}
+
+// Takes log_printf output while this thread steps a core in parallel
+static void stageStdout(const char *text) {
+    stageText("%s", text);
+}
+
+void append_logf(SimulationState *state, const char *format, ...) {
+    if (state->quiet) return;
+    va_list args;
+    va_start(args, format);
+    if (stage != NULL) {
+        stageEvent(false, format, args);
+        va_end(args);
+        return;
+    }
+    log_record(&state->log, state->clockCycle, state->runningPid, format, args);
+    va_end(args);
+    update_log_view(state);
+}
+
+void append_log(SimulationState *state, const char *message) {
+    append_logf(state, "%s", message);
+}
 
 int countInstructions(const char* filename) {
     FILE* file = fopen(filename, "r");
     if (!file) {
-        append_log(&sim_state, g_strdup_printf("Error opening file: %s", filename));
+        append_logf(&sim_state, "Error opening file: %s", filename);
         return -1;
     }
 
@@ -49,307 +133,563 @@ int countInstructions(const char* filename) {
     return count;
 }
 
+// Read and decode a program before its image is placed, so the image can be
+// sized for its variables. Returns the number of lines, -1 on error.
+static int readProgram(const char* filename, int lines, char (*text)[MAX_LINE_LENGTH], Instruction* code, int* variables) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        append_logf(&sim_state, "Error opening file: %s", filename);
+        return -1;
+    }
+    char line[MAX_LINE_LENGTH];
+    int count = 0;
+    while (count < lines && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\n")] = 0;
+        if (strlen(line) == 0) continue;
+        snprintf(text[count++], MAX_LINE_LENGTH, "%s", line);
+    }
+    fclose(file);
+
+    // Decode once so execution never has to parse the text again
+    *variables = decodeProgram(text, count, code);
+    return *variables < 0 ? -1 : count;
+}
+
 int loadProgram(const char* filename, int pid) {
-    if (pid <= 0 || sim_state.numProcesses >= MAX_PROCESSES) {
-        append_log(&sim_state, g_strdup_printf("Invalid PID %d or max processes reached", pid));
+    if (pid <= 0 || sim_state.numProcesses >= limits.maxProcesses) {
+        append_logf(&sim_state, "Invalid PID %d or max processes reached", pid);
         return -1;
     }
     int totalInstructions = countInstructions(filename);
     if (totalInstructions <= 0) return -1;
 
-    int totalNeeded = 6 + totalInstructions + 3;
-    if (totalNeeded > availableMemory) {
-        append_log(&sim_state, g_strdup_printf("Not enough memory: Needed %d, Available %d", totalNeeded, availableMemory));
+    // The program is read into scratch space until its image is placed
+    ArenaMark scratch = arena_mark();
+    char (*programText)[MAX_LINE_LENGTH] = arena_alloc((size_t)totalInstructions * MAX_LINE_LENGTH);
+    Instruction* programCode = arena_alloc(totalInstructions * sizeof(Instruction));
+    int variables = 0;
+    if (!programText || !programCode ||
+        (totalInstructions = readProgram(filename, totalInstructions, programText, programCode, &variables)) < 0) {
+        arena_release(scratch);
         return -1;
     }
+    int variableWords = variables > MIN_VARIABLE_WORDS ? variables : MIN_VARIABLE_WORDS;
 
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        append_log(&sim_state, g_strdup_printf("Error opening file: %s", filename));
+    int totalNeeded = PCB_WORDS + totalInstructions + variableWords;
+    int canSwap = swap_enabled() && totalNeeded <= limits.memorySize;
+    if (totalNeeded > availableMemory && !canSwap && !paging_enabled()) {
+        arena_release(scratch);
+        append_logf(&sim_state, "Not enough memory: Needed %d, Available %d", totalNeeded, availableMemory);
         return -1;
     }
 
-    int lowerBound = MEMORY_SIZE - availableMemory;
-    snprintf(memory[lowerBound], MAX_LINE_LENGTH, "pid : %d", pid);
-    snprintf(memory[lowerBound + 1], MAX_LINE_LENGTH, "state : Ready");
-    snprintf(memory[lowerBound + 2], MAX_LINE_LENGTH, "priority : 1");
-    snprintf(memory[lowerBound + 3], MAX_LINE_LENGTH, "pc : %d", lowerBound + 6);
-    snprintf(memory[lowerBound + 4], MAX_LINE_LENGTH, "lowerBound : %d", lowerBound);
-
-    availableMemory -= 6;
-
-    char line[MAX_LINE_LENGTH];
-    int currentIndex = lowerBound + 6;
-
-    while (fgets(line, sizeof(line), file)) {
-        line[strcspn(line, "\n")] = 0;
-        if (strlen(line) == 0) continue;
-
-        snprintf(memory[currentIndex], MAX_LINE_LENGTH, "%s", line);
-        currentIndex++;
-        availableMemory--;
+    // In paging mode the image is built in the page table and nothing is
+    // placed in memory until its pages are first touched
+    int lowerBound = 0;
+    if (!paging_enabled()) {
+        lowerBound = allocateImage(totalNeeded, -1);
+        if (lowerBound == -1) {
+            arena_release(scratch);
+            AllocStats stats;
+            alloc_stats(&stats);
+            append_logf(&sim_state, "No free block of %d words (largest free block %d)", totalNeeded, stats.largestFree);
+            return -1;
+        }
+    }
+    int slot = create_pcb(pid, 1, lowerBound, lowerBound + totalNeeded - 1);
+    if (slot == -1) {
+        arena_release(scratch);
+        if (!paging_enabled()) free_region(lowerBound, totalNeeded);
+        append_logf(&sim_state, "No free PCB slot for PID %d", pid);
+        return -1;
+    }
+    pcbTable.variables[slot] = variableWords;
+
+    char (*text)[MAX_LINE_LENGTH] = &memory[lowerBound];
+    Instruction* code = &decoded[lowerBound];
+    if (paging_enabled()) {
+        if (paging_map(slot, totalNeeded) != 0) {
+            arena_release(scratch);
+            free_pcb(slot);
+            append_logf(&sim_state, "No page table for PID %d", pid);
+            return -1;
+        }
+        text = pcbTable.pageTable[slot]->text;
+        code = pcbTable.pageTable[slot]->code;
+    } else {
+        swap_resident(slot);
+        availableMemory -= totalNeeded;
     }
 
-    fclose(file);
+    memcpy(text[PCB_WORDS], programText, (size_t)totalInstructions * MAX_LINE_LENGTH);
+    memcpy(&code[PCB_WORDS], programCode, totalInstructions * sizeof(Instruction));
+    arena_release(scratch);
 
-    snprintf(memory[currentIndex], MAX_LINE_LENGTH, "Empty");
-    snprintf(memory[currentIndex + 1], MAX_LINE_LENGTH, "Empty");
-    snprintf(memory[currentIndex + 2], MAX_LINE_LENGTH, "Empty");
+    int currentIndex = PCB_WORDS + totalInstructions;
+    for (int i = currentIndex; i < totalNeeded; i++) {
+        snprintf(text[i], MAX_LINE_LENGTH, "Empty");
+        memset(&code[i], 0, sizeof(Instruction)); // No value yet
+        code[i].type = INVALID;
+    }
 
-    availableMemory -= 3;
-    snprintf(memory[lowerBound + 5], MAX_LINE_LENGTH, "upperBound : %d", currentIndex + 2);
+    if (!paging_enabled()) markMemoryDirty(lowerBound, totalNeeded);
 
     // Update simulation state
     ProcessInfo *info = &sim_state.processes[sim_state.numProcesses++];
     info->pid = pid;
-    strcpy(info->state, "Ready");
+    info->state = READY;
     info->priority = 1;
     info->lowerBound = lowerBound;
-    info->upperBound = currentIndex + 2;
-    info->pc = lowerBound + 6;
+    info->upperBound = lowerBound + totalNeeded - 1;
+    info->pc = lowerBound + PCB_WORDS;
     info->arrivalTime = 0;
     strcpy(info->currentInstruction, "");
     info->timeInQueue = 0;
+    info->queuedAt = sim_state.clockCycle;
+    info->cyclesRun = 0;
 
-    memcpy(sim_state.memory, memory, sizeof(memory));
-    update_gui(&sim_state);
+    mark_dirty(&sim_state, DIRTY_PROCESSES | DIRTY_MEMORY | DIRTY_OVERVIEW);
     return 0;
 }
 
-void updateVariable(int pid, const char* variableName, const char* value) {
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PID %d not found", pid));
-        return;
-    }
-
-    int upperBound;
-    sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
-    //append_log(&sim_state, g_strdup_printf("PID %d: updateVariable searching region [%d, %d] for %s", pid, lowerBound, upperBound, variableName));
+static int compareLowerBound(const void* a, const void* b) {
+    return pcbTable.lowerBound[*(const int*)a] - pcbTable.lowerBound[*(const int*)b];
+}
 
-    for (int i = upperBound-2; i <= upperBound; i++) {
-        if (strncmp(memory[i], variableName, strlen(variableName)) == 0 && memory[i][strlen(variableName)] == ' ') {
-            snprintf(memory[i], MAX_LINE_LENGTH, "%s : %s", variableName, value);
-            memcpy(sim_state.memory, memory, sizeof(memory));
-            update_gui(&sim_state);
-            append_log(&sim_state, g_strdup_printf("PID %d: Updated variable %s = %s at slot %d", pid, variableName, value, i));
-            return;
+int compactMemory(void) {
+    if (limits.fit == FIT_BUDDY || paging_enabled()) {
+        append_logf(&sim_state, "Compaction is not available with buddy allocation or paging");
+        return 0;
+    }
+    ArenaMark scratch = arena_mark();
+    int* order = arena_alloc((pcbTable.count + 1) * sizeof(int));
+    int* shift = arena_alloc(pcbTable.capacity * sizeof(int));
+    if (!order || !shift) {
+        arena_release(scratch);
+        append_logf(&sim_state, "Compaction failed: out of host memory");
+        return 0;
+    }
+    memset(shift, 0, pcbTable.capacity * sizeof(int));
+    int live = 0;
+    for (int slot = 0; slot < pcbTable.capacity; slot++) {
+        if (pcbTable.used[slot] && pcbTable.swapOffset[slot] < 0) order[live++] = slot;
+    }
+    qsort(order, live, sizeof(int), compareLowerBound);
+
+    // Images keep their relative order, so each one moves down into space
+    // already vacated and memmove never overwrites a word still to be copied
+    int next = 0;
+    int end = 0;
+    int moved = 0;
+    for (int i = 0; i < live; i++) {
+        int slot = order[i];
+        int lowerBound = pcbTable.lowerBound[slot];
+        int size = pcbTable.upperBound[slot] - lowerBound + 1;
+        shift[slot] = next - lowerBound;
+        if (lowerBound + size > end) end = lowerBound + size;
+        if (shift[slot] != 0) {
+            memmove(memory[next], memory[lowerBound], (size_t)size * MAX_LINE_LENGTH);
+            memmove(&decoded[next], &decoded[lowerBound], size * sizeof(Instruction));
+            pcbTable.lowerBound[slot] += shift[slot];
+            pcbTable.upperBound[slot] += shift[slot];
+            pcbTable.pc[slot] += shift[slot];
+            moved += size;
         }
+        next += size;
     }
 
-    // If not found, create it in the first empty slot
-    for (int i = upperBound-3; i <= upperBound; i++) {
-        if (strlen(memory[i]) == 0 || strcmp(memory[i], "Empty") == 0) {
-            snprintf(memory[i], MAX_LINE_LENGTH, "%s : %s", variableName, value);
-            memcpy(sim_state.memory, memory, sizeof(memory));
-            update_gui(&sim_state);
-            append_log(&sim_state, g_strdup_printf("PID %d: Created variable %s = %s at slot %d", pid, variableName, value, i));
-            return;
+    if (moved > 0) {
+        for (int i = next; i < end; i++) {
+            memory[i][0] = '\0';
+            decoded[i].type = INVALID;
+        }
+        markMemoryDirty(0, end);
+        for (int i = 0; i < sim_state.numProcesses; i++) {
+            ProcessInfo* info = &sim_state.processes[i];
+            int slot = findPCB(info->pid);
+            if (slot == -1 || pcbTable.swapOffset[slot] >= 0) continue;
+            info->lowerBound += shift[slot];
+            info->upperBound += shift[slot];
+            info->pc += shift[slot];
         }
     }
+    arena_release(scratch);
+    alloc_compacted(next);
+
+    int cycles = (moved + COMPACTION_WORDS_PER_CYCLE - 1) / COMPACTION_WORDS_PER_CYCLE;
+    sim_state.clockCycle += cycles;
+    sim_state.compactions++;
+    sim_state.wordsCompacted += moved;
+    sim_state.compactionCycles += cycles;
+    append_logf(&sim_state, "Compacted memory: moved %d words, charged %d cycles", moved, cycles);
+    mark_dirty(&sim_state, DIRTY_OVERVIEW | DIRTY_PROCESSES | DIRTY_MEMORY);
+    return moved;
+}
 
-    append_log(&sim_state, g_strdup_printf("PID %d: No empty variable slot for %s", pid, variableName));
+// Compact between cycles once enough of the free memory is outside the
+// largest free block that loads start failing for lack of a hole
+static void compactIfFragmented(void) {
+    if (limits.compactThreshold == 0 || limits.fit == FIT_BUDDY || paging_enabled()) return;
+    AllocStats stats;
+    alloc_stats(&stats);
+    if (stats.freeWords == 0) return;
+    int scattered = 100 - (int)(100LL * stats.largestFree / stats.freeWords);
+    if (scattered >= limits.compactThreshold) compactMemory();
 }
 
-char* getVariableValue(int pid, const char* variableName) {
-    char value[50];
-    char* returnValue;
-    returnValue = malloc(MAX_LINE_LENGTH);
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Process not found for %s", pid, variableName));
-        return NULL;
+// PIDs are handed out in increasing order and entries are appended as they
+// load and closed up when they are freed, so the table stays sorted by PID
+ProcessInfo* processInfo(int pid) {
+    int low = 0;
+    int high = sim_state.numProcesses - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        int found = sim_state.processes[mid].pid;
+        if (found == pid) return &sim_state.processes[mid];
+        if (found < pid) low = mid + 1;
+        else high = mid - 1;
     }
+    return NULL;
+}
 
-    int upperBound;
-    sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
-    //append_log(&sim_state, g_strdup_printf("PID %d: getVariableValue searching region [%d, %d] for %s", pid, lowerBound, upperBound, variableName));
+// Write a process image to the backing store and give its words back. While
+// swapped out the PCB bounds and PC are kept relative to a base of 0.
+static int swapOutProcess(int slot) {
+    int pid = pcbTable.pid[slot];
+    int lowerBound = pcbTable.lowerBound[slot];
+    int size = pcbTable.upperBound[slot] - lowerBound + 1;
+    long offset = swap_out_image(pid, lowerBound, size);
+    if (offset < 0) return -1;
 
-    for (int i = upperBound - 2; i <= upperBound; i++) {
-        if (strncmp(memory[i], variableName, strlen(variableName)) == 0 && memory[i][strlen(variableName)] == ' ') {
-            if (sscanf(memory[i], "%*s : %s", value) == 1) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Found %s = '%s' at slot %d", pid, variableName, value, i));
-                strcpy(returnValue, value);
-                return returnValue;
-            } else {
-                append_log(&sim_state, g_strdup_printf("PID %d: %s empty at slot %d", pid, variableName, i));
-                return "";
-            }
+    for (int i = lowerBound; i < lowerBound + size; i++) {
+        memory[i][0] = '\0';
+        decoded[i].type = INVALID;
+    }
+    markMemoryDirty(lowerBound, size);
+    free_region(lowerBound, size);
+    availableMemory += size;
+
+    pcbTable.swapOffset[slot] = offset;
+    pcbTable.lowerBound[slot] = 0;
+    pcbTable.upperBound[slot] = size - 1;
+    pcbTable.pc[slot] -= lowerBound;
+    ProcessInfo* info = processInfo(pid);
+    if (info) {
+        info->pc -= lowerBound;
+        info->lowerBound = -1; // Not in memory
+        info->upperBound = -1;
+    }
+    append_logf(&sim_state, "PID %d: Swapped out %d words", pid, size);
+    mark_dirty(&sim_state, DIRTY_OVERVIEW | DIRTY_PROCESSES | DIRTY_MEMORY);
+    return 0;
+}
+
+// Find room for an image of 'words' words, compacting or swapping other
+// processes out as allowed. excludeSlot is never chosen as a victim.
+static int allocateImage(int words, int excludeSlot) {
+    int base = alloc_region(words);
+    while (base == -1) {
+        if (limits.compactThreshold > 0 && limits.fit != FIT_BUDDY && availableMemory >= words) {
+            // Enough free words, just not in one block
+            compactMemory();
+            base = alloc_region(words);
+            if (base != -1) break;
         }
+        if (!swap_enabled()) break;
+        // The process waiting for input gets its variable written from outside
+        int victim = swap_pick_victim(excludeSlot, findPCB(sim_state.waiting_for_input_pid));
+        if (victim == -1 || swapOutProcess(victim) != 0) break;
+        base = alloc_region(words);
     }
-    append_log(&sim_state, g_strdup_printf("PID %d: %s not found in variable slots", pid, variableName));
-    return NULL;
+    return base;
+}
+
+// Bring a swapped-out process back before it runs; 0 once it is in memory
+static int ensureResident(int slot) {
+    if (pcbTable.swapOffset[slot] < 0) return 0;
+    int pid = pcbTable.pid[slot];
+    int size = pcbTable.upperBound[slot] + 1;
+    int base = allocateImage(size, slot);
+    if (base == -1) {
+        append_logf(&sim_state, "PID %d: No room to swap in %d words", pid, size);
+        return -1;
+    }
+    if (swap_in_image(pcbTable.swapOffset[slot], pid, base) != 0) {
+        free_region(base, size);
+        return -1;
+    }
+    markMemoryDirty(base, size);
+    availableMemory -= size;
+
+    pcbTable.swapOffset[slot] = -1;
+    pcbTable.lowerBound[slot] = base;
+    pcbTable.upperBound[slot] = base + size - 1;
+    pcbTable.pc[slot] += base;
+    swap_resident(slot);
+    ProcessInfo* info = processInfo(pid);
+    if (info) {
+        info->pc += base;
+        info->lowerBound = base;
+        info->upperBound = base + size - 1;
+    }
+    append_logf(&sim_state, "PID %d: Swapped in at %d", pid, base);
+    mark_dirty(&sim_state, DIRTY_OVERVIEW | DIRTY_PROCESSES | DIRTY_MEMORY);
+    return 0;
+}
+
+// Memory word holding a process address; in paging mode this translates it
+// and may fault the page in
+static int physicalAddress(int slot, int address) {
+    return paging_enabled() ? paging_translate(slot, address) : address;
+}
+
+// Text of a word for display. Paging mode reads the frame if the page is
+// resident and the image copy otherwise, so it is never counted or faulted in.
+static const char* wordText(int slot, int address) {
+    if (!paging_enabled()) return memory[address];
+    int at = paging_lookup(slot, address);
+    return at >= 0 ? memory[at] : pcbTable.pageTable[slot]->text[address];
+}
+
+// Variable words sit at the top of the process image, one per slot
+static int variableAddress(int slot, int variable) {
+    return physicalAddress(slot, pcbTable.upperBound[slot] - pcbTable.variables[slot] + 1 + variable);
 }
 
-void executeInstruction(int pid, const char* command, const char* arg1, const char* arg2, Queue* queues) {
-    InstructionType type = getInstructionType(command);
-    if (type == INVALID) {
-        append_log(&sim_state, g_strdup_printf("Invalid instruction: %s", command));
+// Store "name : value" in the variable's word for the memory view and keep the
+// typed value in the word's decoded entry; name is taken from the source line
+static void storeVariable(int pid, int slot, int variable, const char* name, int nameLength, const char* value) {
+    if (variable < 0) {
+        append_logf(&sim_state, "PID %d: No variable %.*s in the program", pid, nameLength, name);
         return;
     }
+    int address = variableAddress(slot, variable);
+    char* word = memory[address];
+    Operand* stored = &decoded[address].arg1;
+    bool existed = stored->kind == OPERAND_LITERAL;
+    int valueLength = strcspn(value, "\r\n");
+    snprintf(word, MAX_LINE_LENGTH, "%.*s : %.*s", nameLength, name, valueLength, value);
+    int length = strlen(word);
+    stored->kind = OPERAND_LITERAL;
+    stored->offset = nameLength + 3 < length ? nameLength + 3 : length;
+    stored->length = length - stored->offset;
+    char* end;
+    long number = strtol(word + stored->offset, &end, 10);
+    stored->isNumber = end != word + stored->offset;
+    stored->number = stored->isNumber ? (int)number : 0;
+    markMemoryDirty(address, 1);
+    mark_dirty(&sim_state, DIRTY_MEMORY);
+    append_logf(&sim_state, "PID %d: %s variable %.*s = %.*s at slot %d", pid, existed ? "Updated" : "Created",
+                nameLength, name, valueLength, value, address);
+}
 
-    if (strcmp(command, "assign") == 0 && strncmp(arg2, "readFile", 8) == 0) { 
-        char filename[50];
-        memset(filename, 0, sizeof(filename));
-        if (sscanf(arg2, "readFile %s", filename) != 1) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Invalid readFile format: %s", pid, arg2));
-            return;
-        }
-        char* file_value = getVariableValue(pid, filename);
-        if (!file_value) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Variable %s not found", pid, filename));
-            return;
-        }
-        FILE* file = fopen(file_value, "r");
-        if (file == NULL) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Cannot open file '%s'", pid, file_value));
-            return;
+// Value of a variable operand, or NULL if it has not been assigned yet. If
+// number is given it receives the value read as an integer (0 if it is not one).
+static const char* loadVariable(int pid, int slot, const char* line, const Operand* op, int* number) {
+    const char* name = line + op->offset;
+    if (op->slot >= 0) {
+        int address = variableAddress(slot, op->slot);
+        const Operand* stored = &decoded[address].arg1;
+        if (stored->kind == OPERAND_LITERAL) {
+            const char* value = memory[address] + stored->offset;
+            append_logf(&sim_state, "PID %d: Found %.*s = '%s' at slot %d", pid, op->length, name, value, address);
+            if (number) *number = stored->number;
+            return value;
         }
-        append_log(&sim_state, g_strdup_printf("PID %d: Reading file '%s'", pid, file_value));
+    }
+    append_logf(&sim_state, "PID %d: %.*s not found in variable slots", pid, op->length, name);
+    return NULL;
+}
 
-        char line[100];
-        while (fgets(line, sizeof(line), file)) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Read %s from %s", pid, line, file_value));
-        }
-        fclose(file);
-        updateVariable(pid, arg1, line);
+void updateVariable(int pid, const char* variableName, const char* value) {
+    int slot = findPCB(pid);
+    if (slot == -1) {
+        append_logf(&sim_state, "PID %d not found", pid);
         return;
     }
 
-    switch (type) {
-        case PRINT: {
-            char* value = getVariableValue(pid, arg1);
-            if (value && strlen(value) > 0) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Print %s = %s", pid, arg1, value));
-            } else if (value) {
-                append_log(&sim_state, g_strdup_printf("PID %d: %s empty", pid, arg1));
-            } else {
-                append_log(&sim_state, g_strdup_printf("PID %d: Print literal %s", pid, arg1));
-            }
-            break;
-        }
+    int first = pcbTable.lowerBound[slot] + PCB_WORDS;
+    int count = pcbTable.upperBound[slot] - pcbTable.variables[slot] + 1 - first;
+    int variable;
+    if (paging_enabled()) {
+        // Program words never change, so the page table's copy is current
+        PageTable* table = pcbTable.pageTable[slot];
+        variable = findVariableSlot(&table->code[first], &table->text[first], count, variableName);
+    } else {
+        variable = findVariableSlot(&decoded[first], &memory[first], count, variableName);
+    }
+    storeVariable(pid, slot, variable, variableName, strlen(variableName), value);
+}
 
-        case ASSIGN: {
-            if (strcmp(arg2, "input") == 0) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Waiting for input for %s", pid, arg1));
-                sim_state.waiting_for_input_pid = pid;
-                strncpy(sim_state.waiting_for_input_var, arg1, sizeof(sim_state.waiting_for_input_var)-1);
-                sim_state.waiting_for_input_var[sizeof(sim_state.waiting_for_input_var)-1] = '\0';
-                // Do not block here; input will be handled by the GUI
-                return;
-            } else {
-                updateVariable(pid, arg1, arg2);
-                append_log(&sim_state, g_strdup_printf("PID %d: Assigned %s = %s", pid, arg1, arg2));
-            }
-            break;
-        }
+// Last line of the file named by a variable, or NULL if it cannot be read
+static const char* readFileLine(int pid, int slot, const char* line, const Operand* op, char* buffer, int size) {
+    const char* file_value = loadVariable(pid, slot, line, op, NULL);
+    if (!file_value) {
+        append_logf(&sim_state, "PID %d: Variable %.*s not found", pid, op->length, line + op->offset);
+        return NULL;
+    }
+    FILE* file = fopen(file_value, "r");
+    if (file == NULL) {
+        append_logf(&sim_state, "PID %d: Cannot open file '%s'", pid, file_value);
+        return NULL;
+    }
+    append_logf(&sim_state, "PID %d: Reading file '%s'", pid, file_value);
 
-        case WRITE_FILE: {
-            char* fileName = getVariableValue(pid, arg1);
-            FILE* file = fopen(fileName, "w");
-            if (file == NULL) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Cannot open file %s", pid, arg1));
-                break;
-            }
+    buffer[0] = '\0';
+    while (fgets(buffer, size, file)) {
+        append_logf(&sim_state, "PID %d: Read %s from %s", pid, buffer, file_value);
+    }
+    fclose(file);
+    return buffer;
+}
 
-            char* value = getVariableValue(pid, arg2);
-            if (value) {
-                fprintf(file, "%s", value);
-                append_log(&sim_state, g_strdup_printf("PID %d: Wrote %s = '%s' to %s", pid, arg2, value, arg1));
-            } else {
-                append_log(&sim_state, g_strdup_printf("PID %d: Variable %s not found", pid, arg2));
-            }
-            fclose(file);
-            break;
+static int operandNumber(int pid, int slot, const char* line, const Operand* op) {
+    if (op->isNumber) return op->number;
+    int number = 0;
+    loadVariable(pid, slot, line, op, &number);
+    return number;
+}
+
+// Instruction handlers. Each returns true when the process has to give up the
+// CPU (blocked on a mutex or waiting for input) before its quantum ends.
+
+static bool execPrint(int pid, int slot, const Instruction* ins, const char* line) {
+    const Operand* arg1 = &ins->arg1;
+    const char* name1 = line + arg1->offset;
+    const char* value = arg1->kind == OPERAND_VARIABLE ? loadVariable(pid, slot, line, arg1, NULL) : NULL;
+    if (value && strlen(value) > 0) {
+        append_logf(&sim_state, "PID %d: Print %.*s = %s", pid, arg1->length, name1, value);
+    } else if (value) {
+        append_logf(&sim_state, "PID %d: %.*s empty", pid, arg1->length, name1);
+    } else {
+        append_logf(&sim_state, "PID %d: Print literal %.*s", pid, arg1->length, name1);
+    }
+    return false;
+}
+
+static bool execAssign(int pid, int slot, const Instruction* ins, const char* line) {
+    const Operand* arg1 = &ins->arg1;
+    const Operand* arg2 = &ins->arg2;
+    const char* name1 = line + arg1->offset;
+    const char* name2 = line + arg2->offset;
+    if (arg2->kind == OPERAND_INPUT) {
+        append_logf(&sim_state, "PID %d: Waiting for input for %.*s", pid, arg1->length, name1);
+        sim_state.waiting_for_input_pid = pid;
+        snprintf(sim_state.waiting_for_input_var, sizeof(sim_state.waiting_for_input_var), "%.*s",
+                 arg1->length, name1);
+        // Do not block here; input will be handled by the GUI
+        return true;
+    } else if (arg2->kind == OPERAND_READ_FILE) {
+        char buffer[MAX_LINE_LENGTH];
+        const char* contents = readFileLine(pid, slot, line, arg2, buffer, sizeof(buffer));
+        if (contents) {
+            storeVariable(pid, slot, arg1->slot, name1, arg1->length, contents);
         }
+    } else {
+        storeVariable(pid, slot, arg1->slot, name1, arg1->length, name2);
+        append_logf(&sim_state, "PID %d: Assigned %.*s = %.*s", pid, arg1->length, name1, arg2->length, name2);
+    }
+    return false;
+}
 
-        case READ_FILE: {
-            char* file_value = getVariableValue(pid, arg1);
-            if (!file_value) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Variable %s not found", pid, arg1));
-                break;
-            }
+static bool execWriteFile(int pid, int slot, const Instruction* ins, const char* line) {
+    const Operand* arg1 = &ins->arg1;
+    const Operand* arg2 = &ins->arg2;
+    const char* name1 = line + arg1->offset;
+    const char* name2 = line + arg2->offset;
+    const char* fileName = loadVariable(pid, slot, line, arg1, NULL);
+    FILE* file = fileName ? fopen(fileName, "w") : NULL;
+    if (file == NULL) {
+        append_logf(&sim_state, "PID %d: Cannot open file %.*s", pid, arg1->length, name1);
+        return false;
+    }
 
-            FILE* file = fopen(file_value, "r");
-            if (file == NULL) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Cannot open file %s", pid, file_value));
-                break;
-            }
+    const char* value = loadVariable(pid, slot, line, arg2, NULL);
+    if (value) {
+        fprintf(file, "%s", value);
+        append_logf(&sim_state, "PID %d: Wrote %.*s = '%s' to %.*s", pid, arg2->length, name2, value, arg1->length, name1);
+    } else {
+        append_logf(&sim_state, "PID %d: Variable %.*s not found", pid, arg2->length, name2);
+    }
+    fclose(file);
+    return false;
+}
 
-            char line[100];
-            while (fgets(line, sizeof(line), file)) {
-                append_log(&sim_state, g_strdup_printf("PID %d: Read %s from %s", pid, line, file_value));
-            }
-            fclose(file);
-            break;
-        }
+static bool execReadFile(int pid, int slot, const Instruction* ins, const char* line) {
+    char buffer[MAX_LINE_LENGTH];
+    readFileLine(pid, slot, line, &ins->arg1, buffer, sizeof(buffer));
+    return false;
+}
 
-        case PRINT_FROM_TO: {
-            int start, end;
-            if (sscanf(arg1, "%d", &start) != 1)
-                start = atoi(getVariableValue(pid, arg1));
-            if (sscanf(arg2, "%d", &end) != 1)
-                end = atoi(getVariableValue(pid, arg2));
-            char output[200] = "";
-            for (int i = start; i <= end; i++) {
-                char num[10];
-                snprintf(num, sizeof(num), "%d ", i);
-                strcat(output, num);
-            }
-            append_log(&sim_state, g_strdup_printf("PID %d: Print from %d to %d: %s", pid, start, end, output));
-            break;
-        }
+static bool execPrintFromTo(int pid, int slot, const Instruction* ins, const char* line) {
+    int start = operandNumber(pid, slot, line, &ins->arg1);
+    int end = operandNumber(pid, slot, line, &ins->arg2);
+    char output[200] = "";
+    int length = 0;
+    for (int i = start; i <= end && length < (int)sizeof(output) - 12; i++) {
+        length += snprintf(output + length, sizeof(output) - length, "%d ", i);
+    }
+    append_logf(&sim_state, "PID %d: Print from %d to %d: %s", pid, start, end, output);
+    return false;
+}
 
-        case SEM_WAIT: {
-            Mutex* mutex = NULL;
-            int mutex_id = -1;
-            if (strcmp(arg1, "userInput") == 0) { mutex = &mutexInput; mutex_id = 0; }
-            else if (strcmp(arg1, "userOutput") == 0) { mutex = &mutexOutput; mutex_id = 2; }
-            else if (strcmp(arg1, "file") == 0) { mutex = &mutexFile; mutex_id = 1; }
-            if (mutex) {
-                if (semWait(mutex, pid, &memory)) {
-                    append_log(&sim_state, g_strdup_printf("PID %d: Acquired %s", pid, arg1));
-                    sim_state.mutexes[mutex_id].locked = mutex->locked;
-                    sim_state.mutexes[mutex_id].ownerPid = mutex->ownerPID;
-                } else {
-                    append_log(&sim_state, g_strdup_printf("PID %d: Blocked on %s", pid, arg1));          //----------------------------------
-                    sim_state.mutexes[mutex_id].locked = mutex->locked;
-                    sim_state.mutexes[mutex_id].ownerPid = mutex->ownerPID;
-                    enqueue(&(mutex->blockedQueue), pid);
-                }
-            } else {
-                append_log(&sim_state, g_strdup_printf("PID %d: Invalid mutex %s", pid, arg1));
-            }
-            break;
-        }
+static bool execSemWait(int pid, int slot, const Instruction* ins, const char* line) {
+    const Operand* arg1 = &ins->arg1;
+    const char* name1 = line + arg1->offset;
+    if (ins->mutex < 0) {
+        append_logf(&sim_state, "PID %d: Invalid mutex %.*s", pid, arg1->length, name1);
+        return false;
+    }
+    Mutex* mutex = mutexByIndex[ins->mutex];
+    bool acquired = semWait(mutex, pid);
+    if (acquired) {
+        append_logf(&sim_state, "PID %d: Acquired %.*s", pid, arg1->length, name1);
+    } else {
+        append_logf(&sim_state, "PID %d: Blocked on %.*s", pid, arg1->length, name1);
+        priorityEnqueue(&(mutex->blockedQueue), pid, pcbTable.priority[slot]);
+    }
+    sim_state.mutexes[ins->mutex].locked = mutex->locked;
+    sim_state.mutexes[ins->mutex].ownerPid = mutex->ownerPID;
+    mark_dirty(&sim_state, DIRTY_MUTEXES | DIRTY_QUEUES);
+    return !acquired;
+}
 
-        case SEM_SIGNAL: {
-            Mutex* mutex = NULL;
-            int mutex_id = -1;
-            if (strcmp(arg1, "userInput") == 0) { mutex = &mutexInput; mutex_id = 0; }
-            else if (strcmp(arg1, "userOutput") == 0) { mutex = &mutexOutput; mutex_id = 2; }
-            else if (strcmp(arg1, "file") == 0) { mutex = &mutexFile; mutex_id = 1; }
-            if (mutex) {
-                semSignal(mutex);
-                append_log(&sim_state, g_strdup_printf("PID %d: Released %s", pid, arg1));            //----------------------------
-                sim_state.mutexes[mutex_id].locked = mutex->locked;
-                sim_state.mutexes[mutex_id].ownerPid = mutex->ownerPID;
-                if (mutex->ownerPID != -1){
-                    enqueue(&unBlockedQueue, mutex->ownerPID);
-                }
-                
-            } else {
-                append_log(&sim_state, g_strdup_printf("PID %d: Invalid mutex %s", pid, arg1));
-            }
-            break;
-        }
+static bool execSemSignal(int pid, int slot, const Instruction* ins, const char* line) {
+    const Operand* arg1 = &ins->arg1;
+    const char* name1 = line + arg1->offset;
+    if (ins->mutex < 0) {
+        append_logf(&sim_state, "PID %d: Invalid mutex %.*s", pid, arg1->length, name1);
+        return false;
+    }
+    Mutex* mutex = mutexByIndex[ins->mutex];
+    semSignal(mutex);
+    append_logf(&sim_state, "PID %d: Released %.*s", pid, arg1->length, name1);
+    sim_state.mutexes[ins->mutex].locked = mutex->locked;
+    sim_state.mutexes[ins->mutex].ownerPid = mutex->ownerPID;
+    mark_dirty(&sim_state, DIRTY_MUTEXES | DIRTY_QUEUES);
+    if (mutex->ownerPID != -1){
+        enqueue(&unBlockedQueue, mutex->ownerPID);
+    }
+    return false;
+}
 
-        case INVALID:
-            append_log(&sim_state, "Invalid instruction");
-            break;
+static bool execInvalid(int pid, int slot, const Instruction* ins, const char* line) {
+    append_logf(&sim_state, "Invalid instruction: %.*s", ins->arg1.length, line + ins->arg1.offset);
+    return false;
+}
+
+bool executeInstruction(int pid, int slot, const Instruction* ins, const char* line) {
+    switch (ins->type) {
+        case PRINT: return execPrint(pid, slot, ins, line);
+        case ASSIGN: return execAssign(pid, slot, ins, line);
+        case WRITE_FILE: return execWriteFile(pid, slot, ins, line);
+        case READ_FILE: return execReadFile(pid, slot, ins, line);
+        case PRINT_FROM_TO: return execPrintFromTo(pid, slot, ins, line);
+        case SEM_WAIT: return execSemWait(pid, slot, ins, line);
+        case SEM_SIGNAL: return execSemSignal(pid, slot, ins, line);
+        case INVALID: return execInvalid(pid, slot, ins, line);
     }
-    memcpy(sim_state.memory, memory, sizeof(memory));
-    update_gui(&sim_state);
+    return false;
 }
 
 
@@ -358,159 +698,191 @@ int isCommand(const char* str) {
     return type != INVALID;
 }
 
+// Run up to limit instructions starting at *pc. Stops early when the process
+// yields or runs past lastInstruction; *lastPc is the address of the final
+// instruction executed. Uses threaded dispatch (computed goto) where the
+// compiler supports it, so a whole quantum runs without returning to the
+// scheduler between instructions.
+static int runInterpreter(int pid, int slot, int* pc, int lastInstruction, int limit, int* lastPc) {
+    int executed = 0;
+    int at;
+    const Instruction* ins;
+    const char* line;
+
+#define FETCH()                                                           \
+    do {                                                                  \
+        if (executed == limit || *pc > lastInstruction) return executed;  \
+        *lastPc = *pc;                                                    \
+        at = paging_enabled() ? paging_fetch(slot, *pc) : *pc;            \
+        ins = &decoded[at];                                               \
+        line = memory[at];                                                \
+        append_logf(&sim_state, "PID %d: Executing : %s", pid, line);     \
+    } while (0)
+
+#if defined(__GNUC__)
+    static void* const dispatch[] = {
+        [PRINT] = &&do_print,
+        [ASSIGN] = &&do_assign,
+        [WRITE_FILE] = &&do_write_file,
+        [READ_FILE] = &&do_read_file,
+        [PRINT_FROM_TO] = &&do_print_from_to,
+        [SEM_WAIT] = &&do_sem_wait,
+        [SEM_SIGNAL] = &&do_sem_signal,
+        [INVALID] = &&do_invalid,
+    };
+    bool yield;
+
+#define NEXT()                          \
+    do {                                \
+        (*pc)++;                        \
+        executed++;                     \
+        if (yield) return executed;     \
+        FETCH();                        \
+        goto *dispatch[ins->type];      \
+    } while (0)
+
+    FETCH();
+    goto *dispatch[ins->type];
+do_print:         yield = execPrint(pid, slot, ins, line); NEXT();
+do_assign:        yield = execAssign(pid, slot, ins, line); NEXT();
+do_write_file:    yield = execWriteFile(pid, slot, ins, line); NEXT();
+do_read_file:     yield = execReadFile(pid, slot, ins, line); NEXT();
+do_print_from_to: yield = execPrintFromTo(pid, slot, ins, line); NEXT();
+do_sem_wait:      yield = execSemWait(pid, slot, ins, line); NEXT();
+do_sem_signal:    yield = execSemSignal(pid, slot, ins, line); NEXT();
+do_invalid:       yield = execInvalid(pid, slot, ins, line); NEXT();
+
+#undef NEXT
+#else
+    for (;;) {
+        FETCH();
+        bool yield = executeInstruction(pid, slot, ins, line);
+        (*pc)++;
+        executed++;
+        if (yield) return executed;
+    }
+#endif
+#undef FETCH
+}
 
+// Execute the running process: one instruction per call, or the whole
+// remaining quantum when sim_state.runWholeQuantum is set.
 int executeForTimeQuantum(int pid, int* pc, int lowerBound, int upperBound, int timeQuantum, Queue* queues) {
-    int instructionsExecuted = 0;
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Program not found", pid));
+    int slot = findPCB(pid);
+    if (slot == -1) {
+        append_logf(&sim_state, "PID %d: Program not found", pid);
         return 0;
     }
 
-    // Execute only one instruction
-    if (*pc <= upperBound - 3) {
-        char instructionLine[MAX_LINE_LENGTH];
-        strcpy(instructionLine, memory[*pc]);
-
-        char command[50];
-        char arg1[50] = "";
-        char arg2[50] = "";
-        sscanf(instructionLine, "%s %s %s", command, arg1, arg2);
-
-        if(strcmp(arg2,"readFile") == 0){
-            sscanf(instructionLine, "%s %s %[^\n]", command, arg1, arg2);
-        }
-
-        append_log(&sim_state, g_strdup_printf("PID %d: Executing : %s", pid, instructionLine));
-        for (int i = 0; i < sim_state.numProcesses; i++) {
-            if (sim_state.processes[i].pid == pid) {
-                strcpy(sim_state.processes[i].currentInstruction, instructionLine);
-                sim_state.processes[i].pc = *pc;
-                break;
-            }
-        }
-
-        executeInstruction(pid, command, arg1, arg2, queues);
-
-        char stateStr[20];
-        sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-        for (int i = 0; i < sim_state.numProcesses; i++) {
-            if (sim_state.processes[i].pid == pid) {
-                strcpy(sim_state.processes[i].state, stateStr);
-                break;
-            }
+    int limit = sim_state.runWholeQuantum ? timeQuantum : 1;
+    int lastPc = *pc;
+    int instructionsExecuted = runInterpreter(pid, slot, pc, upperBound - pcbTable.variables[slot], limit, &lastPc);
+
+    if (instructionsExecuted > 0) {
+        ProcessInfo* info = processInfo(pid);
+        if (info) {
+            strcpy(info->currentInstruction, wordText(slot, lastPc));
+            info->pc = lastPc;
+            info->state = pcbTable.state[slot];
+            info->cyclesRun += instructionsExecuted;
         }
-
-        // if (strcmp(stateStr, "Blocked") == 0) {
-        //     append_log(&sim_state, g_strdup_printf("PID %d: Blocked after instruction", pid));
-        //     return 0;
-        // }
-
-        (*pc)++;
-        instructionsExecuted = 1;
+        *stepInstructions += instructionsExecuted;
+        mark_dirty(&sim_state, DIRTY_PROCESSES | DIRTY_MEMORY);
     }
-    update_gui(&sim_state);
     return instructionsExecuted;
 }
 
 void freeProgram(int pid) {
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Not found for freeProgram", pid));
+    int slot = findPCB(pid);
+    if (slot == -1) {
+        append_logf(&sim_state, "PID %d: Not found for freeProgram", pid);
         return;
     }
 
-    int lowerBound, upperBound;
-    sscanf(memory[pcbIndex + 4], "lowerBound : %d", &lowerBound);
-    sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
+    int lowerBound = pcbTable.lowerBound[slot];
+    int upperBound = pcbTable.upperBound[slot];
+
+    if (paging_enabled()) {
+        paging_release(slot);
+        free_pcb(slot);
+        availableMemory = paging_free_words();
+    } else {
+        for (int i = lowerBound; i <= upperBound; i++) {
+            memory[i][0] = '\0';
+            decoded[i].type = INVALID;
+        }
+        markMemoryDirty(lowerBound, upperBound - lowerBound + 1);
+        free_pcb(slot);
 
-    for (int i = lowerBound; i <= upperBound; i++) {
-        memory[i][0] = '\0';
+        free_region(lowerBound, upperBound - lowerBound + 1);
+        availableMemory += (upperBound - lowerBound + 1);
     }
+    append_logf(&sim_state, "Freed PID %d, available memory: %d", pid, availableMemory);
 
-    availableMemory += (upperBound - lowerBound + 1);
-    append_log(&sim_state, g_strdup_printf("Freed PID %d, available memory: %d", pid, availableMemory));
+    ProcessInfo* info = processInfo(pid);
+    if (info) {
+        ProcessInfo* end = &sim_state.processes[sim_state.numProcesses];
+        memmove(info, info + 1, (end - info - 1) * sizeof(ProcessInfo));
+        sim_state.numProcesses--;
+    }
+    mark_dirty(&sim_state, DIRTY_PROCESSES | DIRTY_QUEUES | DIRTY_MEMORY | DIRTY_OVERVIEW);
+}
 
-    for (int i = 0; i < sim_state.numProcesses; i++) {
-        if (sim_state.processes[i].pid == pid) {
-            for (int j = i; j < sim_state.numProcesses - 1; j++) {
-                sim_state.processes[j] = sim_state.processes[j + 1];
-            }
-            sim_state.numProcesses--;
-            break;
+static void showBlockedQueues(void) {
+    Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
+    for (int i = 0; i < 3; i++) {
+        PriorityQueue* blocked = &allMutexes[i]->blockedQueue;
+        int waiting = priorityQueueSize(blocked);
+        if (waiting == 0) continue;
+        // Shown in wake order, not heap order
+        ArenaMark scratch = arena_mark();
+        int* order = arena_alloc(waiting * sizeof(int));
+        if (order == NULL) return;
+        priorityInOrder(blocked, order);
+        for (int k = 0; k < waiting; k++) {
+            enqueue(&sim_state.blockedQueue, order[k]);
         }
+        arena_release(scratch);
     }
-    memcpy(sim_state.memory, memory, sizeof(memory));
-    update_gui(&sim_state);
 }
 
-void update_simulation_state(Queue *queues, int numQueues, int runningPid) {
-    sim_state.runningPid = runningPid;
-    initializeQueue(&sim_state.readyQueue);
-    initializeQueue(&sim_state.blockedQueue);
-
-    // Process scheduler queues
+static void showReadyQueues(Queue *queues, int numQueues) {
     for (int i = 0; i < numQueues; i++) {
-        Queue tempQueue;
-        initializeQueue(&tempQueue);
-        // Copy queue to temp to process without modifying original
-        int count = countQueueElements(&queues[i]);
-        for (int j = 0; j < count; j++) {
-            int pid = dequeue(&queues[i]);
-            if (pid > 0) {
-                enqueue(&tempQueue, pid);
-                enqueue(&queues[i], pid); // Restore original queue
-            }
-        }
-        // Add temp queue elements to readyQueue
-        while (!isEmpty(&tempQueue)) {
-            int pid = dequeue(&tempQueue);
+        for (int pid = queueFirst(&queues[i]); pid > 0; pid = queueNext(&queues[i], pid)) {
             enqueue(&sim_state.readyQueue, pid);
-            for (int j = 0; j < sim_state.numProcesses; j++) {
-                if (sim_state.processes[j].pid == pid) {
-                    sim_state.processes[j].timeInQueue++;
-                }
-            }
         }
     }
+}
 
-    // Process mutex blocked queues
+// Mutex states for the GUI. With several cores runSmpCycle copies them once a
+// cycle, since cores stepped on worker threads must not write shared state.
+static void showMutexes(void) {
     Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
     for (int i = 0; i < 3; i++) {
-        Queue tempQueue;
-        initializeQueue(&tempQueue);
-        int count = countQueueElements(&allMutexes[i]->blockedQueue);
-        for (int j = 0; j < count; j++) {
-            int pid = dequeue(&allMutexes[i]->blockedQueue);
-            if (pid > 0) {
-                enqueue(&tempQueue, pid);
-                enqueue(&allMutexes[i]->blockedQueue, pid); // Restore original queue
-            }
-        }
-        while (!isEmpty(&tempQueue)) {
-            int pid = dequeue(&tempQueue);
-            enqueue(&sim_state.blockedQueue, pid);
-            for (int j = 0; j < sim_state.numProcesses; j++) {
-                if (sim_state.processes[j].pid == pid) {
-                    sim_state.processes[j].timeInQueue++;
-                }
-            }
-        }
+        sim_state.mutexes[i].locked = allMutexes[i]->locked;
+        sim_state.mutexes[i].ownerPid = allMutexes[i]->ownerPID;
     }
+}
 
-    update_gui(&sim_state);
+// Queues of the last single-core scheduler step, for sync_queue_view
+static Queue* shownQueues = NULL;
+static int shownLevels = 0;
+
+void update_simulation_state(Queue *queues, int numQueues, int runningPid) {
+    *stepPid = runningPid;
+    if (smp_enabled()) return; // sync_queue_view reads every core's queues
+    shownQueues = queues;
+    shownLevels = numQueues;
+    mark_dirty(&sim_state, DIRTY_QUEUES | DIRTY_PROCESSES);
 }
 
 void mlfqSchedulerCycle(Queue queues[NUM_QUEUES]) {
     int active = 0;
+    int startCycle = *stepClock;
 
     Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
     int numMutexes = 3;
-
-    for (int i = 0; i < numMutexes; i++) {
-        sim_state.mutexes[i].locked = allMutexes[i]->locked;
-        sim_state.mutexes[i].ownerPid = allMutexes[i]->ownerPID;
-    }
+    if (!smp_enabled()) showMutexes();
 
     // Process instructions from the highest priority non-empty queue
     for (int i = 0; i < NUM_QUEUES; i++) {
@@ -518,38 +890,39 @@ void mlfqSchedulerCycle(Queue queues[NUM_QUEUES]) {
 
         int pid = peek(&queues[i]);
         if (pid <= 0) {
-            append_log(&sim_state, g_strdup_printf("Invalid PID %d, skipping", pid));
+            append_logf(&sim_state, "Invalid PID %d, skipping", pid);
             dequeue(&queues[i]);
             continue;
         }
-        int pcbIndex = findPCBStartIndex(pid);
-        if (pcbIndex == -1) {
-            append_log(&sim_state, g_strdup_printf("PCB not found for PID %d", pid));
+        int slot = findPCB(pid);
+        if (slot == -1) {
+            append_logf(&sim_state, "PCB not found for PID %d", pid);
             dequeue(&queues[i]);
             continue;
         }
 
-        char stateStr[20];
-        sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-        if (strcmp(stateStr, "Blocked") == 0) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Blocked", pid));
+        if (pcbTable.state[slot] == BLOCKED) {
+            append_logf(&sim_state, "PID %d: Blocked", pid);
             active = 1;
             dequeue(&queues[i]);
             enqueue(&queues[i], pid);
             continue;
         }
 
-        if (strcmp(stateStr, "Terminated") == 0) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Terminated, skipping", pid));
+        if (pcbTable.state[slot] == TERMINATED) {
+            append_logf(&sim_state, "PID %d: Terminated, skipping", pid);
             dequeue(&queues[i]);
             continue;
         }
 
-        int pc, lowerBound, upperBound, priority;
-        sscanf(memory[pcbIndex + 3], "pc : %d", &pc);
-        sscanf(memory[pcbIndex + 4], "lowerBound : %d", &lowerBound);
-        sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
-        sscanf(memory[pcbIndex + 2], "priority : %d", &priority);
+        if (ensureResident(slot) != 0) {
+            dequeue(&queues[i]);
+            enqueue(&queues[i], pid);
+            continue;
+        }
+
+        int lowerBound = pcbTable.lowerBound[slot];
+        int upperBound = pcbTable.upperBound[slot];
 
         int timeQuantum;
         switch (i) {
@@ -561,225 +934,221 @@ void mlfqSchedulerCycle(Queue queues[NUM_QUEUES]) {
         }
 
         // Track instructions executed for this process in this queue
-        static int executed[MAX_PROCESSES] = {0};
-        if (executed[pid] == 0) {
-            append_log(&sim_state, g_strdup_printf("Executing PID %d from Queue %d [PC=%d, TQ=%d]", pid, i, pc, timeQuantum));
+        if (pcbTable.quantumUsed[slot] == 0) {
+            append_logf(&sim_state, "Executing PID %d from Queue %d [PC=%d, TQ=%d]", pid, i, pcbTable.pc[slot], timeQuantum);
         }
 
-        snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Running");
-        sim_state.runningPid = pid;
+        update_pcb_state(slot, RUNNING);
+        *stepPid = pid;
 
-        // Execute one instruction
-        int result = executeForTimeQuantum(pid, &pc, lowerBound, upperBound, timeQuantum, queues);
-        executed[pid] += result;
+        // Execute one instruction (or the rest of the quantum in runWholeQuantum mode)
+        int result = executeForTimeQuantum(pid, &pcbTable.pc[slot], lowerBound, upperBound,
+                                           timeQuantum - pcbTable.quantumUsed[slot], queues);
+        pcbTable.quantumUsed[slot] += result;
 
-        sim_state.clockCycle++;
-        append_log(&sim_state, g_strdup_printf("MLFQ Cycle %d", sim_state.clockCycle));
+        *stepClock += result > 1 ? result : 1;
+        append_logf(&sim_state, "MLFQ Cycle %d", *stepClock);
 
-        snprintf(memory[pcbIndex + 3], MAX_LINE_LENGTH, "pc : %d", pc);
-
-        sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-        if (strcmp(stateStr, "Blocked") == 0) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Blocked after instruction", pid));
+        if (pcbTable.state[slot] == BLOCKED) {
+            append_logf(&sim_state, "PID %d: Blocked after instruction", pid);
             active = 1;
             dequeue(&queues[i]);
             enqueue(&queues[i], pid);
-            sim_state.runningPid = 0;
-            executed[pid] = 0; // Reset execution count on block
+            *stepPid = 0;
+            pcbTable.quantumUsed[slot] = 0; // Reset execution count on block
             break;
         }
 
-        if (pc > upperBound - 3) {
-            append_log(&sim_state, g_strdup_printf("PID %d: Finished after instruction", pid));
-            snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Terminated");
+        if (pcbTable.pc[slot] > upperBound - pcbTable.variables[slot]) {
+            append_logf(&sim_state, "PID %d: Finished after instruction", pid);
+            update_pcb_state(slot, TERMINATED);
             releaseMutexOnTermination(&mutexFile, pid);
             releaseMutexOnTermination(&mutexInput, pid);
             releaseMutexOnTermination(&mutexOutput, pid);
             freeProgram(pid);
             dequeue(&queues[i]);
-            sim_state.runningPid = 0;
-            executed[pid] = 0; // Reset execution count on termination
+            *stepPid = 0;
             break;
         }
 
         active = 1;
         int targetQueue = i;
-        if (executed[pid] >= timeQuantum && i < NUM_QUEUES - 1) {
+        if (pcbTable.quantumUsed[slot] >= timeQuantum && i < NUM_QUEUES - 1) {
             targetQueue = i + 1;
-            append_log(&sim_state, g_strdup_printf("Demoting PID %d to Queue %d", pid, targetQueue));
-            executed[pid] = 0; // Reset execution count on demotion
+            append_logf(&sim_state, "Demoting PID %d to Queue %d", pid, targetQueue);
+            pcbTable.quantumUsed[slot] = 0; // Reset execution count on demotion
+        } else if (pcbTable.quantumUsed[slot] >= timeQuantum) {
+            pcbTable.quantumUsed[slot] = 0; // Lowest level: requeue with a fresh quantum
         }
 
+        update_pcb_state(slot, READY);
         dequeue(&queues[i]);
         enqueue(&queues[targetQueue], pid);
-        sim_state.runningPid = 0;
+        *stepPid = 0;
 
         // Update simulation state and GUI after each instruction
-        update_simulation_state(queues, NUM_QUEUES, sim_state.runningPid);
+        update_simulation_state(queues, NUM_QUEUES, *stepPid);
         break; // Process only one process per cycle
     }
 
-    if (sim_state.clockCycle >= MAX_CYCLES) {
-        append_log(&sim_state, g_strdup_printf("Reached max cycles (%d). Possible deadlock", MAX_CYCLES));
+    // Nothing ran (empty queues or every head blocked): the cycle still elapses,
+    // as in RR/FCFS, so pending arrivals and deadlock detection can make progress
+    if (*stepClock == startCycle) {
+        (*stepClock)++;
+    }
+
+    if (limits.maxCycles > 0 && *stepClock >= limits.maxCycles) {
+        append_logf(&sim_state, "Reached max cycles (%d). Possible deadlock", limits.maxCycles);
         active = 0;
     }
 
     int totalBlocked = 0;
     for (int i = 0; i < numMutexes; i++) {
-        totalBlocked += countQueueElements(&allMutexes[i]->blockedQueue);
+        totalBlocked += priorityQueueSize(&allMutexes[i]->blockedQueue);
     }
-    if (!active && totalBlocked > 0 && sim_state.clockCycle > DEADLOCK_THRESHOLD) {
-        append_log(&sim_state, g_strdup_printf("Deadlock: %d processes blocked", totalBlocked));
+    // With several cores it is only a deadlock once every core has run dry
+    if (!active && totalBlocked > 0 && *stepClock > DEADLOCK_THRESHOLD && !smp_other_cores_busy()) {
+        append_logf(&sim_state, "Deadlock: %d processes blocked", totalBlocked);
         for (int i = 0; i < numMutexes; i++) {
-            Queue tempQueue;
-            initializeQueue(&tempQueue);
-            int count = countQueueElements(&allMutexes[i]->blockedQueue);
-            for (int j = 0; j < count; j++) {
-                int pid = dequeue(&allMutexes[i]->blockedQueue);
-                if (pid > 0) {
-                    enqueue(&tempQueue, pid);
-                    enqueue(&allMutexes[i]->blockedQueue, pid); // Restore original queue
-                }
-            }
-            while (!isEmpty(&tempQueue)) {
-                int pid = dequeue(&tempQueue);
-                enqueue(&sim_state.mutexes[i].blockedQueue, pid);
-            }
-            while (!isEmpty(&allMutexes[i]->blockedQueue)) {
-                int pid = dequeueHighestPriority(&allMutexes[i]->blockedQueue);
+            PriorityQueue* blocked = &allMutexes[i]->blockedQueue;
+            while (priorityQueueSize(blocked) > 0) {
+                int pid = priorityDequeue(blocked);
                 if (pid <= 0) continue;
-                int pcbIndex = findPCBStartIndex(pid);
-                if (pcbIndex == -1) continue;
-                char stateStr[20];
-                sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-                if (strcmp(stateStr, "Terminated") == 0) continue;
-                deadlock_attempts[pid]++;
-                if (deadlock_attempts[pid] >= MAX_DEADLOCK_ATTEMPTS) {
-                    append_log(&sim_state, g_strdup_printf("PID %d: Exceeded deadlock attempts, terminating", pid));
-                    snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Terminated");
+                enqueue(&sim_state.mutexes[i].blockedQueue, pid); // Shown in wake order
+                int slot = findPCB(pid);
+                if (slot == -1) continue;
+                if (pcbTable.state[slot] == TERMINATED) continue;
+                pcbTable.deadlockAttempts[slot]++;
+                if (pcbTable.deadlockAttempts[slot] >= MAX_DEADLOCK_ATTEMPTS) {
+                    append_logf(&sim_state, "PID %d: Exceeded deadlock attempts, terminating", pid);
+                    update_pcb_state(slot, TERMINATED);
                     releaseMutexOnTermination(&mutexFile, pid);
                     releaseMutexOnTermination(&mutexInput, pid);
                     releaseMutexOnTermination(&mutexOutput, pid);
+                    // With several cores the process sits in its own core's queues
+                    Queue* held = smp_enabled() ? smp_core(pcbTable.cpu[slot])->queues : queues;
                     freeProgram(pid);
                     for (int k = 0; k < NUM_QUEUES; k++) {
-                        dequeueByPID(&queues[k], pid);
+                        dequeueByPID(&held[k], pid);
                     }
                     continue;
                 }
                 unblockProcess(pid);
                 int priority = getProcessPriority(pid);
                 int targetQueue = (priority >= 0 && priority < NUM_QUEUES) ? priority : 1;
-                enqueue(&queues[targetQueue], pid);
-                append_log(&sim_state, g_strdup_printf("PID %d: Unblocked to Queue %d", pid, targetQueue));
+                if (smp_enabled()) {
+                    enqueue(&smp_core(pcbTable.cpu[slot])->queues[targetQueue], pid);
+                } else {
+                    enqueue(&queues[targetQueue], pid);
+                }
+                append_logf(&sim_state, "PID %d: Unblocked to Queue %d", pid, targetQueue);
                 active = 1;
             }
         }
     }
 
-    update_simulation_state(queues, NUM_QUEUES, sim_state.runningPid);
-    if (!active) {
+    update_simulation_state(queues, NUM_QUEUES, *stepPid);
+    if (!active && !smp_enabled()) { // runSmpCycle reports it once for all cores
         append_log(&sim_state, "All processes finished (MLFQ)");
     }
 }
 
 void rrSchedulerCycle(Queue *queue) {
     int active = 0;
-    sim_state.clockCycle++;
+    (*stepClock)++;
 
-    Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
-    int numMutexes = 3;
-
-    for (int i = 0; i < numMutexes; i++) {
-        sim_state.mutexes[i].locked = allMutexes[i]->locked;
-        sim_state.mutexes[i].ownerPid = allMutexes[i]->ownerPID;
-    }
+    if (!smp_enabled()) showMutexes();
 
     for (int i = 0; i < countQueueElements(&unBlockedQueue); i++){
         enqueue(queue, dequeue(&unBlockedQueue));
     }
 
-    append_log(&sim_state, g_strdup_printf("RR Cycle %d", sim_state.clockCycle));
+    append_logf(&sim_state, "RR Cycle %d", *stepClock);
 
     if (isEmpty(queue)) return;
 
     int pid = peek(queue);
     if (pid <= 0) {
-        append_log(&sim_state, g_strdup_printf("Invalid PID %d, skipping", pid));
+        append_logf(&sim_state, "Invalid PID %d, skipping", pid);
         dequeue(queue);
         rrSchedulerCycle(queue);
         return;
     }
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PCB not found for PID %d", pid));
+    int slot = findPCB(pid);
+    if (slot == -1) {
+        append_logf(&sim_state, "PCB not found for PID %d", pid);
         dequeue(queue);
         rrSchedulerCycle(queue);
         return;
     }
 
-    char stateStr[20];
-    sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-    if (strcmp(stateStr, "Blocked") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Blocked", pid));
+    if (pcbTable.state[slot] == BLOCKED) {
+        append_logf(&sim_state, "PID %d: Blocked", pid);
         active = 1;
         dequeue(queue);
         rrSchedulerCycle(queue);
         return;
     }
 
-    if (strcmp(stateStr, "Terminated") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Terminated, skipping", pid));
+    if (pcbTable.state[slot] == TERMINATED) {
+        append_logf(&sim_state, "PID %d: Terminated, skipping", pid);
         dequeue(queue);
         rrSchedulerCycle(queue);
         return;
     }
 
-    int pc, lowerBound, upperBound, priority;
-    sscanf(memory[pcbIndex + 3], "pc : %d", &pc);
-    sscanf(memory[pcbIndex + 4], "lowerBound : %d", &lowerBound);
-    sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
-    sscanf(memory[pcbIndex + 2], "priority : %d", &priority);
+    if (ensureResident(slot) != 0) {
+        dequeue(queue);
+        enqueue(queue, pid);
+        return;
+    }
 
-    append_log(&sim_state, g_strdup_printf("Executing PID %d [PC=%d, TQ=%d]", pid, pc, sim_state.rrQuantum));
+    int lowerBound = pcbTable.lowerBound[slot];
+    int upperBound = pcbTable.upperBound[slot];
 
-    sim_state.runningPid = pid;
+    append_logf(&sim_state, "Executing PID %d [PC=%d, TQ=%d]", pid, pcbTable.pc[slot], sim_state.rrQuantum);
 
-    executeForTimeQuantum(pid, &pc, lowerBound, upperBound, sim_state.rrQuantum, queue);
-    snprintf(memory[pcbIndex + 3], MAX_LINE_LENGTH, "pc : %d", pc);
-    
-    sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-    if (strcmp(stateStr, "Blocked") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Blocked", pid));
+    update_pcb_state(slot, RUNNING);
+    *stepPid = pid;
+
+    int executed = executeForTimeQuantum(pid, &pcbTable.pc[slot], lowerBound, upperBound, quantaCount, queue);
+    if (executed > 1) {
+        *stepClock += executed - 1;
+    }
+
+    if (pcbTable.state[slot] == BLOCKED) {
+        append_logf(&sim_state, "PID %d: Blocked", pid);
         active = 1;
         dequeue(queue);
-        sim_state.runningPid = 0;
+        *stepPid = 0;
         return;
     }
 
-    if (pc > upperBound - 3) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Finished", pid));
-        snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Terminated");
+    if (pcbTable.pc[slot] > upperBound - pcbTable.variables[slot]) {
+        append_logf(&sim_state, "PID %d: Finished", pid);
+        update_pcb_state(slot, TERMINATED);
         releaseMutexOnTermination(&mutexFile, pid);
         releaseMutexOnTermination(&mutexInput, pid);
         releaseMutexOnTermination(&mutexOutput, pid);
         freeProgram(pid);
         dequeue(queue);
-        sim_state.runningPid = 0;
+        *stepPid = 0;
         return;
     }
-    if (quantaCount == 1){
+    update_pcb_state(slot, READY);
+    quantaCount -= executed > 1 ? executed : 1;
+    if (quantaCount <= 0){
         active = 1;
-        append_log(&sim_state, g_strdup_printf("Re-enqueuing PID %d after instruction", pid));
+        append_logf(&sim_state, "Re-enqueuing PID %d after instruction", pid);
         dequeue(queue);
         enqueue(queue, pid);
         quantaCount = sim_state.rrQuantum;
         return;
     }
         active = 1;
-        quantaCount--;
     
 
-    sim_state.runningPid = 0;
+    *stepPid = 0;
 
 
     //             if (pid > 0) {
@@ -801,7 +1170,7 @@ void rrSchedulerCycle(Queue *queue) {
     //             if (strcmp(stateStr, "Terminated") == 0) continue;
     //             deadlock_attempts[pid]++;
     //             if (deadlock_attempts[pid] >= MAX_DEADLOCK_ATTEMPTS) {
-    //                 append_log(&sim_state, g_strdup_printf("PID %d: Exceeded deadlock attempts, terminating", pid));
+    //                 append_logf(&sim_state, "PID %d: Exceeded deadlock attempts, terminating", pid);
     //                 snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Terminated");
     //                 releaseMutexOnTermination(&mutexFile, pid);
     //                 releaseMutexOnTermination(&mutexInput, pid);
@@ -812,134 +1181,180 @@ void rrSchedulerCycle(Queue *queue) {
     //             }
     //             unblockProcess(pid);
     //             enqueue(queue, pid);
-    //             append_log(&sim_state, g_strdup_printf("PID %d: Unblocked to Queue", pid));
+    //             append_logf(&sim_state, "PID %d: Unblocked to Queue", pid);
     //             active = 1;
     //         }
     //     }
     // }
 
-    update_simulation_state(queue, 1, sim_state.runningPid);
-    if (!active) {
+    update_simulation_state(queue, 1, *stepPid);
+    if (!active && !smp_enabled()) { // runSmpCycle reports it once for all cores
         append_log(&sim_state, "All processes finished (Round-Robin)");
     }
 }
 
 void fcfsSchedulerCycle(Queue *queue) {
     int active = 0;
-    sim_state.clockCycle++;
-
-    Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
-    int numMutexes = 3;
+    (*stepClock)++;
 
-    for (int i = 0; i < numMutexes; i++) {
-        sim_state.mutexes[i].locked = allMutexes[i]->locked;
-        sim_state.mutexes[i].ownerPid = allMutexes[i]->ownerPID;
-    }
+    if (!smp_enabled()) showMutexes();
 
-    append_log(&sim_state, g_strdup_printf("FCFS Cycle %d", sim_state.clockCycle));
+    append_logf(&sim_state, "FCFS Cycle %d", *stepClock);
 
     if (isEmpty(queue)) return;
 
     int pid = peek(queue);
     if (pid <= 0) {
-        append_log(&sim_state, g_strdup_printf("Invalid PID %d, skipping", pid));
+        append_logf(&sim_state, "Invalid PID %d, skipping", pid);
         dequeue(queue);
         return;
     }
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
-        append_log(&sim_state, g_strdup_printf("PCB not found for PID %d", pid));
+    int slot = findPCB(pid);
+    if (slot == -1) {
+        append_logf(&sim_state, "PCB not found for PID %d", pid);
         dequeue(queue);
         return;
     }
 
-    char stateStr[20];
-    sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-    if (strcmp(stateStr, "Blocked") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Blocked", pid));
+    if (pcbTable.state[slot] == BLOCKED) {
+        append_logf(&sim_state, "PID %d: Blocked", pid);
         active = 1;
         dequeue(queue);
         enqueue(queue, pid);
         return;
     }
 
-    if (strcmp(stateStr, "Terminated") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Terminated, skipping", pid));
+    if (pcbTable.state[slot] == TERMINATED) {
+        append_logf(&sim_state, "PID %d: Terminated, skipping", pid);
         dequeue(queue);
         return;
     }
 
-    int pc, lowerBound, upperBound, priority;
-    sscanf(memory[pcbIndex + 3], "pc : %d", &pc);
-    sscanf(memory[pcbIndex + 4], "lowerBound : %d", &lowerBound);
-    sscanf(memory[pcbIndex + 5], "upperBound : %d", &upperBound);
-    sscanf(memory[pcbIndex + 2], "priority : %d", &priority);
+    if (ensureResident(slot) != 0) {
+        dequeue(queue);
+        enqueue(queue, pid);
+        return;
+    }
+
+    int lowerBound = pcbTable.lowerBound[slot];
+    int upperBound = pcbTable.upperBound[slot];
 
-    append_log(&sim_state, g_strdup_printf("Executing PID %d [PC=%d, TQ=Unlimited]", pid, pc));
+    append_logf(&sim_state, "Executing PID %d [PC=%d, TQ=Unlimited]", pid, pcbTable.pc[slot]);
 
-    snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Running");
-    sim_state.runningPid = pid;
-    int executed = executeForTimeQuantum(pid, &pc, lowerBound, upperBound, INT_MAX, queue);
-    snprintf(memory[pcbIndex + 3], MAX_LINE_LENGTH, "pc : %d", pc);
+    update_pcb_state(slot, RUNNING);
+    *stepPid = pid;
+    int executed = executeForTimeQuantum(pid, &pcbTable.pc[slot], lowerBound, upperBound, INT_MAX, queue);
+    if (executed > 1) {
+        *stepClock += executed - 1;
+    }
 
-    sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-    if (strcmp(stateStr, "Blocked") == 0) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Blocked", pid));
+    if (pcbTable.state[slot] == BLOCKED) {
+        append_logf(&sim_state, "PID %d: Blocked", pid);
         active = 1;
         dequeue(queue);
         enqueue(queue, pid);
-        sim_state.runningPid = 0;
+        *stepPid = 0;
         return;
     }
 
-    if (pc > upperBound - 3) {
-        append_log(&sim_state, g_strdup_printf("PID %d: Finished", pid));
-        snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Terminated");
+    if (pcbTable.pc[slot] > upperBound - pcbTable.variables[slot]) {
+        append_logf(&sim_state, "PID %d: Finished", pid);
+        update_pcb_state(slot, TERMINATED);
         releaseMutexOnTermination(&mutexFile, pid);
         releaseMutexOnTermination(&mutexInput, pid);
         releaseMutexOnTermination(&mutexOutput, pid);
         freeProgram(pid);
         dequeue(queue);
-        sim_state.runningPid = 0;
+        *stepPid = 0;
         return;
     }
 
+    update_pcb_state(slot, READY);
     if (executed > 0) {
         active = 1;
     }
-    sim_state.runningPid = 0;
+    *stepPid = 0;
 
 
 
-    update_simulation_state(queue, 1, sim_state.runningPid);
-    if (!active) {
+    update_simulation_state(queue, 1, *stepPid);
+    if (!active && !smp_enabled()) { // runSmpCycle reports it once for all cores
         append_log(&sim_state, "All processes finished (FCFS)");
     }
 }
 
 void add_process(SimulationState *state, const char *filename, int arrivalTime) {
-    int pid = state->numProcesses + 1;
+    int pid = state->nextPid++;
     if (loadProgram(filename, pid) == 0) {
-        for (int i = 0; i < state->numProcesses; i++) {
-            if (state->processes[i].pid == pid) {
-                state->processes[i].arrivalTime = arrivalTime;
-                if (arrivalTime <= state->clockCycle) {
-                    enqueue(&state->readyQueue, pid);
-                }
-                break;
+        // loadProgram appends the new process
+        ProcessInfo* info = &state->processes[state->numProcesses - 1];
+        info->arrivalTime = arrivalTime;
+        if (arrivalTime > info->queuedAt) info->queuedAt = arrivalTime;
+        priorityEnqueue(&arrivals, pid, arrivalTime);
+        if (arrivalTime <= state->clockCycle) {
+            enqueue(&state->readyQueue, pid);
+        }
+    }
+}
+
+// Add every process listed in a schedule file, one "program [arrival [cpus]]"
+// per line ('#' starts a comment; cpus is an affinity list such as 0-3,8).
+// Returns the number added, -1 on the first line that cannot be read or loaded.
+int load_arrival_schedule(SimulationState *state, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        printf("Error opening arrival schedule: %s\n", path);
+        return -1;
+    }
+    char line[MAX_LINE_LENGTH + 160];
+    int lineNumber = 0;
+    int added = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        char program[MAX_LINE_LENGTH];
+        char cpus[128];
+        int arrival = 0;
+        char extra;
+        int fields = sscanf(line, "%99s %d %127s %c", program, &arrival, cpus, &extra);
+        if (fields <= 0) continue;
+        unsigned long long affinity = ~0ULL;
+        if (fields == 4 || arrival < 0) {
+            printf("%s:%d: expected \"program [arrival [cpus]]\"\n", path, lineNumber);
+            fclose(file);
+            return -1;
+        }
+        if (fields == 3) {
+            unsigned long long cores = limits.cores == 64 ? ~0ULL : (1ULL << limits.cores) - 1;
+            if (parseAffinity(cpus, &affinity) != 0 || (affinity & cores) == 0) {
+                printf("%s:%d: no usable CPU in '%s' (%d cores)\n", path, lineNumber, cpus, limits.cores);
+                fclose(file);
+                return -1;
             }
         }
+        int before = state->numProcesses;
+        add_process(state, program, arrival);
+        if (state->numProcesses == before) {
+            printf("%s:%d: failed to load %s\n", path, lineNumber, program);
+            fclose(file);
+            return -1;
+        }
+        pcbTable.affinity[findPCB(state->nextPid - 1)] = affinity;
+        added++;
     }
+    fclose(file);
+    return added;
 }
 
 void reset_simulation(SimulationState *state) {
     state->numProcesses = 0;
+    state->nextPid = 1;
     state->clockCycle = 0;
     state->runningPid = 0;
     strcpy(state->schedulerType, "mlfq");
     state->rrQuantum = RR_TIME_QUANTUM;
-    memset(state->processes, 0, sizeof(state->processes));
-    memset(state->log, 0, sizeof(state->log));
+    memset(state->processes, 0, limits.maxProcesses * sizeof(ProcessInfo));
+    log_clear(&state->log);
     initializeQueue(&state->readyQueue);
     initializeQueue(&state->blockedQueue);
     for (int i = 0; i < 3; i++) {
@@ -947,11 +1362,302 @@ void reset_simulation(SimulationState *state) {
         state->mutexes[i].locked = 0;
         state->mutexes[i].ownerPid = 0;
     }
-    memset(memory, 0, sizeof(memory));
-    availableMemory = MEMORY_SIZE;
+    memset(memory, 0, (size_t)limits.memorySize * MAX_LINE_LENGTH);
+    markMemoryDirty(0, limits.memorySize);
+    memset(decoded, 0, limits.memorySize * sizeof(Instruction));
+    availableMemory = limits.memorySize;
+    alloc_init(limits.memorySize, limits.fit);
+    paging_init(limits.memorySize, limits.pageSize, limits.tlbEntries, limits.pagePolicy);
+    if (swap_enabled()) swap_open(limits.swapFile, limits.swapPolicy);
+    smp_init(limits.cores, limits.balanceInterval, limits.balancer, limits.migrationCost);
+    state->compactions = 0;
+    state->wordsCompacted = 0;
+    state->compactionCycles = 0;
+    state->idleJumps = 0;
+    state->idleCyclesSkipped = 0;
+    state->parallelSteps = 0;
+    state->serialSteps = 0;
+    initializePriorityQueue(&arrivals);
+    arena_reset();
+    reset_pcb_table();
     initMutexes();
-    memcpy(state->memory, memory, sizeof(memory));
-    update_gui(state);
+    mark_dirty(state, DIRTY_ALL);
+}
+
+// Next process whose arrival cycle has been reached, -1 if none
+static int dueArrival(int clock) {
+    int pid = priorityPeek(&arrivals);
+    if (pid == -1 || priorityOf(&arrivals, pid) > clock) return -1;
+    return priorityDequeue(&arrivals);
+}
+
+// True if the scheduler has nothing to pick from these run queues
+static bool coreIdle(SimulationState *state, Queue queues[NUM_QUEUES], Queue *woken) {
+    bool mlfq = strcmp(state->schedulerType, "mlfq") == 0;
+    for (int i = 0; i < (mlfq ? NUM_QUEUES : 1); i++) {
+        if (!isEmpty(&queues[i])) return false;
+    }
+    return strcmp(state->schedulerType, "rr") != 0 || isEmpty(woken);
+}
+
+// Discrete-event fast path. When nothing can run before the next arrival the
+// cycles in between only advance the clock, so jump to the cycle before it and
+// let the scheduler's own idle cycle land on the arrival. Everything except the
+// per-cycle heartbeat and max_cycles warning records ends up as if each cycle
+// had been stepped.
+static void skipIdleCycles(SimulationState *state, Queue queues[NUM_QUEUES]) {
+    if (state->stepIdleCycles || state->waiting_for_input_pid > 0) return;
+    if (smp_enabled()) {
+        for (int c = 0; c < smp_cores(); c++) {
+            if (!coreIdle(state, smp_core(c)->queues, &smp_core(c)->unblocked)) return;
+        }
+    } else if (!coreIdle(state, queues, &unBlockedQueue)) {
+        return;
+    }
+    if (strcmp(state->schedulerType, "mlfq") == 0) {
+        // Blocked processes make MLFQ run deadlock detection every cycle
+        for (int i = 0; i < 3; i++) {
+            if (priorityQueueSize(&mutexByIndex[i]->blockedQueue) > 0) return;
+        }
+    }
+
+    int next = state->cycleLimit > 0 ? state->cycleLimit : INT_MAX;
+    if (priorityQueueSize(&arrivals) > 0) {
+        int arrival = priorityOf(&arrivals, priorityPeek(&arrivals));
+        // Arrived while a compaction was charged; it is enqueued next cycle
+        if (arrival <= state->clockCycle) return;
+        if (arrival < next) next = arrival;
+    }
+    if (next == INT_MAX || next - 1 <= state->clockCycle) return;
+
+    append_logf(state, "Idle: clock skipped from %d to %d", state->clockCycle, next - 1);
+    state->idleJumps++;
+    state->idleCyclesSkipped += next - 1 - state->clockCycle;
+    state->clockCycle = next - 1;
+}
+
+static void runScheduler(SimulationState *state, Queue queues[NUM_QUEUES]) {
+    if (strcmp(state->schedulerType, "mlfq") == 0) {
+        mlfqSchedulerCycle(queues);
+    } else if (strcmp(state->schedulerType, "rr") == 0) {
+        rrSchedulerCycle(&queues[0]);
+    } else if (strcmp(state->schedulerType, "fcfs") == 0) {
+        fcfsSchedulerCycle(&queues[0]);
+    }
+}
+
+static void swapQueues(Queue *a, Queue *b) {
+    Queue held = *a;
+    *a = *b;
+    *b = held;
+}
+
+static bool smpBusy(void) {
+    for (int c = 0; c < smp_cores(); c++) {
+        if (smp_load(c) > 0) return true;
+    }
+    return false;
+}
+
+static const char* schedulerTitle(const char *type) {
+    if (strcmp(type, "rr") == 0) return "Round-Robin";
+    if (strcmp(type, "fcfs") == 0) return "FCFS";
+    return "MLFQ";
+}
+
+// One scheduler cycle on a core's run queues, starting from 'start'
+static void stepCore(SimulationState *state, int c, int start) {
+    Core *core = smp_core(c);
+    long executed = *stepInstructions;
+    *stepClock = start;
+    quantaCount = core->quantaCount > 0 ? core->quantaCount : state->rrQuantum;
+    swapQueues(&unBlockedQueue, &core->unblocked);
+    smp_begin_step(c);
+    runScheduler(state, core->queues);
+    smp_end_step();
+    swapQueues(&unBlockedQueue, &core->unblocked);
+    core->quantaCount = quantaCount;
+    core->busyCycles += *stepInstructions - executed;
+}
+
+static int levelQuantum(int level) {
+    static const int quanta[NUM_QUEUES] = {TIME_QUANTUM_0, TIME_QUANTUM_1, TIME_QUANTUM_2, TIME_QUANTUM_3};
+    return quanta[level];
+}
+
+// Instructions that only read and write the process's own words
+static bool ownWordsOnly(const Instruction* ins) {
+    switch (ins->type) {
+        case PRINT:
+        case PRINT_FROM_TO:
+        case INVALID:
+            return true;
+        case ASSIGN:
+            return ins->arg2.kind != OPERAND_INPUT && ins->arg2.kind != OPERAND_READ_FILE;
+        default:
+            return false; // Mutexes, files and input are shared
+    }
+}
+
+// Whether a core's step this cycle can run on a worker thread. It has to run
+// the ready, resident process at the head of its queues for instructions that
+// neither finish the process nor touch anything but its own words. None of the
+// core's processes may wait on a mutex or have been woken, so the cores
+// stepped before it in core order cannot change its queues.
+static bool stepsAlone(SimulationState *state, int c, int start, unsigned long long waitingCores) {
+    Core *core = smp_core(c);
+    if (core->stall > 0 || !isEmpty(&core->unblocked) || (waitingCores & (1ULL << c))) return false;
+    bool mlfq = strcmp(state->schedulerType, "mlfq") == 0;
+    int level = 0;
+    while (mlfq && level < NUM_QUEUES - 1 && isEmpty(&core->queues[level])) level++;
+    int pid = queueFirst(&core->queues[level]);
+    int slot = pid > 0 ? findPCB(pid) : -1;
+    if (slot == -1 || pcbTable.state[slot] != READY || pcbTable.swapOffset[slot] >= 0) return false;
+
+    int window = 1; // Instructions the step may execute
+    if (state->runWholeQuantum) {
+        if (mlfq) window = levelQuantum(level) - pcbTable.quantumUsed[slot];
+        else if (strcmp(state->schedulerType, "rr") == 0) window = core->quantaCount > 0 ? core->quantaCount : state->rrQuantum;
+        else return false; // FCFS runs the process to its end
+    }
+    int pc = pcbTable.pc[slot];
+    if (window < 1 || pc + window > pcbTable.upperBound[slot] - pcbTable.variables[slot]) return false;
+    if (limits.maxCycles > 0 && start + window >= limits.maxCycles) return false;
+    for (int at = pc; at < pc + window; at++) {
+        if (!ownWordsOnly(&decoded[at])) return false;
+    }
+    return true;
+}
+
+// Cores with a process waiting on a mutex, one bit per core
+static unsigned long long coresWaiting(void) {
+    Mutex* allMutexes[] = {&mutexInput, &mutexFile, &mutexOutput};
+    unsigned long long waiting = 0;
+    for (int i = 0; i < 3; i++) {
+        PriorityQueue* blocked = &allMutexes[i]->blockedQueue;
+        for (int k = 0; k < blocked->size; k++) {
+            int slot = findPCB(blocked->heap[k]);
+            if (slot != -1) waiting |= 1ULL << pcbTable.cpu[slot];
+        }
+    }
+    return waiting;
+}
+
+static int* parallelCores = NULL; // Cores stepped on worker threads this cycle
+static bool* steppedInParallel = NULL;
+static int parallelStart;
+
+static void stepInParallel(int item) {
+    int c = parallelCores[item];
+    stage = &stages[c];
+    stage->count = 0;
+    stage->clock = parallelStart;
+    stage->runningPid = -1;
+    stage->instructions = 0;
+    stage->dirty = 0;
+    stepClock = &stage->clock;
+    stepPid = &stage->runningPid;
+    stepInstructions = &stage->instructions;
+    log_capture_stdout(stageStdout);
+    stepCore(&sim_state, c, parallelStart);
+    log_capture_stdout(NULL);
+    stage = NULL;
+    stepClock = &sim_state.clockCycle;
+    stepPid = &sim_state.runningPid;
+    stepInstructions = &sim_state.instructionsExecuted;
+}
+
+// Pick the cores to step on worker threads this cycle; 0 when it is not worth it
+static int planParallelSteps(SimulationState *state, int start) {
+    if (workers_count() < 2 || paging_enabled()) return 0;
+    if (swap_enabled()) {
+        // A swap-in could evict another core's process mid-cycle
+        SwapStats swapStats;
+        swap_stats(&swapStats);
+        if (swapStats.pagesInUse > 0) return 0;
+    }
+    if (stages == NULL) {
+        stages = heap_calloc(smp_cores(), sizeof(CoreStage));
+        parallelCores = heap_calloc(smp_cores(), sizeof(int));
+        steppedInParallel = heap_calloc(smp_cores(), sizeof(bool));
+        if (!stages || !parallelCores || !steppedInParallel) {
+            printf("memory error for %d core stages\n", smp_cores());
+            exit(1);
+        }
+    }
+    unsigned long long waitingCores = coresWaiting();
+    int count = 0;
+    for (int c = 0; c < smp_cores(); c++) {
+        steppedInParallel[c] = stepsAlone(state, c, start, waitingCores);
+        if (steppedInParallel[c]) parallelCores[count++] = c;
+    }
+    if (count < 2) {
+        for (int i = 0; i < count; i++) {
+            steppedInParallel[parallelCores[i]] = false;
+        }
+        return 0;
+    }
+    return count;
+}
+
+// Log records, stdout text, running PID, instructions and redraw flags of a
+// core stepped in parallel, applied where its step falls in core order
+static void mergeStage(SimulationState *state, CoreStage *staged) {
+    for (int i = 0; i < staged->count; i++) {
+        LogRecord* record = &staged->events[i].record;
+        if (staged->events[i].toStdout) {
+            update_log_view(state); // The records before it are shown first
+            char text[LOG_ARG_BYTES];
+            log_format(record, text, sizeof(text));
+            fputs(text, stdout);
+            continue;
+        }
+        if (record->pid == -1) record->pid = state->runningPid;
+        log_append(&state->log, record);
+    }
+    if (staged->count > 0) update_log_view(state);
+    if (staged->runningPid != -1) state->runningPid = staged->runningPid;
+    state->instructionsExecuted += staged->instructions;
+    if (staged->dirty) mark_dirty(state, staged->dirty);
+}
+
+// SMP mode: each core runs one scheduler cycle on its own run queues, starting
+// from the same clock value, and the clock then moves on by the longest step.
+// With threads > 1 the cores whose step only touches their own process run
+// first, on worker threads. The rest (mutexes, files, input, finishing,
+// stalls) then run in core order on this thread, and each parallel step's
+// results are merged at its place in that order, so the log and the outcome
+// are the same as with one thread.
+static void runSmpCycle(SimulationState *state) {
+    int start = state->clockCycle;
+    int end = start + 1;
+    bool busy = smpBusy();
+    int parallel = planParallelSteps(state, start);
+    if (parallel > 0) {
+        parallelStart = start;
+        workers_run(stepInParallel, parallel);
+        state->parallelSteps += parallel;
+    }
+    for (int c = 0; c < smp_cores(); c++) {
+        int clock;
+        if (parallel > 0 && steppedInParallel[c]) {
+            mergeStage(state, &stages[c]);
+            clock = stages[c].clock;
+        } else {
+            if (smp_stalled(c)) continue; // Paying for a migration, runs nothing
+            stepCore(state, c, start);
+            clock = state->clockCycle;
+            if (workers_count() > 1) state->serialSteps++;
+        }
+        smp_route_unblocked(c);
+        if (clock > end) end = clock;
+    }
+    state->clockCycle = end;
+    smp_tick(end);
+    showMutexes();
+    if (busy && !smpBusy()) {
+        append_logf(state, "All processes finished (%s)", schedulerTitle(state->schedulerType));
+    }
 }
 
 void run_simulation_cycle(SimulationState *state) {
@@ -962,52 +1668,153 @@ void run_simulation_cycle(SimulationState *state) {
         for (int i = 0; i < NUM_QUEUES; i++) {
             initializeQueue(&queues[i]);
         }
-        for (int i = 0; i < state->numProcesses; i++) {
-            if (state->processes[i].arrivalTime <= state->clockCycle) {
-                enqueue(&queues[0], state->processes[i].pid);
-            }
-        }
         initialized = 1;
     }
 
-    // Enqueue processes that have arrived
-    for (int i = 0; i < state->numProcesses; i++) {
-        if (state->processes[i].arrivalTime == state->clockCycle) {
-            enqueue(&queues[0], state->processes[i].pid);
-            append_log(state, g_strdup_printf("PID %d: Arrived", state->processes[i].pid));
+    // Enqueue processes that have arrived, including any whose arrival
+    // the clock skipped over while running a whole quantum
+    for (int pid; (pid = dueArrival(state->clockCycle)) != -1;) {
+        if (smp_enabled()) {
+            append_logf(state, "PID %d: Arrived on CPU %d", pid, smp_place(pid));
+        } else {
+            enqueue(&queues[0], pid);
+            append_logf(state, "PID %d: Arrived", pid);
         }
     }
+    compactIfFragmented();
+    skipIdleCycles(state, queues);
 
-    if (strcmp(state->schedulerType, "mlfq") == 0) {
-        mlfqSchedulerCycle(queues);
-    } else if (strcmp(state->schedulerType, "rr") == 0) {
-        rrSchedulerCycle(&queues[0]);
-    } else if (strcmp(state->schedulerType, "fcfs") == 0) {
-        fcfsSchedulerCycle(&queues[0]);
+    if (smp_enabled()) {
+        runSmpCycle(state);
+    } else {
+        runScheduler(state, queues);
     }
 
-    // Real-time GUI updates
-    update_process_list();
-    update_queue_list();
-    update_overview();
+    // Clock and process states moved; the frontend redraws once per frame
+    mark_dirty(state, DIRTY_OVERVIEW | DIRTY_PROCESSES | DIRTY_QUEUES);
 }
 
-int main(int argc, char *argv[]) {
-    // Initialize simulation state
-    memset(&sim_state, 0, sizeof(sim_state));
-    strcpy(sim_state.schedulerType, "mlfq");
-    sim_state.rrQuantum = RR_TIME_QUANTUM;
+void mark_dirty(SimulationState *state, unsigned panels) {
+    if (stage != NULL) {
+        stage->dirty |= panels;
+        return;
+    }
+    state->dirty |= panels;
+    update_gui(state);
+}
+
+void markMemoryDirty(int first, int count) {
+    // Atomic, as cores stepped in parallel may share a word of bits
+    for (int i = first; i < first + count; i++) {
+        __atomic_fetch_or(&memoryDirty[i / 64], 1ULL << (i % 64), __ATOMIC_RELAXED);
+    }
+}
+
+void sync_memory_view(SimulationState *state, void (*changed)(int first, int count)) {
+    renderPCBs();
+    int runStart = -1;
+    int runEnd = -1;
+    if (state->memory == NULL) {
+        state->memory = heap_calloc(limits.memorySize, MAX_LINE_LENGTH);
+        if (state->memory == NULL) {
+            printf("memory error for the memory view\n");
+            return;
+        }
+        markMemoryDirty(0, limits.memorySize);
+    }
+    for (int w = 0; w < (limits.memorySize + 63) / 64; w++) {
+        unsigned long long bits = memoryDirty[w];
+        memoryDirty[w] = 0;
+        for (int bit = 0; bits; bit++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            int address = w * 64 + bit;
+            memcpy(state->memory[address], memory[address], MAX_LINE_LENGTH);
+            if (address != runEnd + 1) {
+                if (runStart >= 0 && changed) changed(runStart, runEnd - runStart + 1);
+                runStart = address;
+            }
+            runEnd = address;
+        }
+    }
+    if (runStart >= 0 && changed) changed(runStart, runEnd - runStart + 1);
+}
+
+void sync_queue_view(SimulationState *state) {
+    initializeQueue(&state->readyQueue);
+    initializeQueue(&state->blockedQueue);
+    if (smp_enabled()) {
+        for (int c = 0; c < smp_cores(); c++) {
+            showReadyQueues(smp_core(c)->queues, NUM_QUEUES);
+        }
+    } else if (shownQueues != NULL) {
+        showReadyQueues(shownQueues, shownLevels);
+    }
+    showBlockedQueues();
+    // Every cycle since it became ready that it did not spend executing
+    for (int i = 0; i < state->numProcesses; i++) {
+        ProcessInfo* info = &state->processes[i];
+        int waited = state->clockCycle - info->queuedAt - info->cyclesRun;
+        info->timeInQueue = waited > 0 ? waited : 0;
+    }
+}
+
+// Allocate memory, decoded instructions and the process list from limits
+static int allocateSimulation(SimulationState *state) {
+    memory = heap_calloc(limits.memorySize, MAX_LINE_LENGTH);
+    decoded = heap_calloc(limits.memorySize, sizeof(Instruction));
+    memoryDirty = heap_calloc((limits.memorySize + 63) / 64, sizeof(unsigned long long));
+    state->processes = heap_calloc(limits.maxProcesses, sizeof(ProcessInfo));
+    if (!memory || !decoded || !memoryDirty || !state->processes) {
+        printf("memory error: cannot allocate %d words and %d processes\n",
+               limits.memorySize, limits.maxProcesses);
+        return -1;
+    }
+    availableMemory = limits.memorySize;
+    if (limits.pageSize > 0) {
+        if (limits.swapFile[0] != '\0') printf("swap_file is ignored in paging mode\n");
+        return paging_init(limits.memorySize, limits.pageSize, limits.tlbEntries, limits.pagePolicy);
+    }
+    if (limits.swapFile[0] != '\0' && swap_open(limits.swapFile, limits.swapPolicy) != 0) return -1;
+    return alloc_init(limits.memorySize, limits.fit);
+}
+
+int init_simulation(SimulationState *state) {
+    memset(state, 0, sizeof(*state));
+    if (allocateSimulation(state) != 0) return -1;
+    state->nextPid = 1;
+    strcpy(state->schedulerType, "mlfq");
+    state->rrQuantum = RR_TIME_QUANTUM;
     initializeQueue(&unBlockedQueue);
-    initializeQueue(&sim_state.readyQueue);
-    initializeQueue(&sim_state.blockedQueue);
+    initializePriorityQueue(&arrivals);
+    initializeQueue(&state->readyQueue);
+    initializeQueue(&state->blockedQueue);
     for (int i = 0; i < 3; i++) {
-        initializeQueue(&sim_state.mutexes[i].blockedQueue);
+        initializeQueue(&state->mutexes[i].blockedQueue);
     }
     initMutexes();
+    reset_pcb_table();
+    smp_init(limits.cores, limits.balanceInterval, limits.balancer, limits.migrationCost);
+    if (limits.cores > 1 && workers_start(limits.threads < limits.cores ? limits.threads : limits.cores) != 0) return -1;
+    return 0;
+}
+
+#ifndef HEADLESS
+int main(int argc, char *argv[]) {
+    // Optional "--config file" before the GTK options; limits must be known
+    // before anything is allocated
+    if (argc > 2 && strcmp(argv[1], "--config") == 0) {
+        if (load_limits_file(argv[2]) != 0) return 1;
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
 
+    // Initialize simulation state
+    if (init_simulation(&sim_state) != 0) return 1;
 
     // Start GUI
     init_gui(argc, argv);
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
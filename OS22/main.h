@@ -1,21 +1,25 @@
 #ifndef MAIN_H
 #define MAIN_H
 
-#include "gui.h"
+#include "simulation.h"
 #include "queue.h"
 #include "mutex.h"
 #include "pcb.h"
 
 extern SimulationState sim_state;
 
+int init_simulation(SimulationState *state); // Allocates from limits, -1 on failure
 void add_process(SimulationState *state, const char *filename, int arrivalTime);
+int load_arrival_schedule(SimulationState *state, const char *path); // Processes added, -1 on error
 void reset_simulation(SimulationState *state);
 void run_simulation_cycle(SimulationState *state);
 int loadProgram(const char *filename, int pid);
+int compactMemory(void); // Slide live images to the bottom of memory, returns words moved
 void update_simulation_state(Queue *queues, int numQueues, int runningPid);
-void mlfqSchedulerCycle(Queue queues[]);
+void mlfqSchedulerCycle(Queue queues[NUM_QUEUES]);
 void rrSchedulerCycle(Queue *queue);
 void fcfsSchedulerCycle(Queue *queue);
 void updateVariable(int pid, const char* variableName, const char* value);
+ProcessInfo* processInfo(int pid); // Entry in sim_state.processes, NULL if not loaded
 
 #endif
\ No newline at end of file
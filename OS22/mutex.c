@@ -3,15 +3,18 @@
 #include <stdio.h>
 #include <string.h>
 
-// Initialize mutexes with explicit braces for Queue struct
-Mutex mutexFile = {1, false, -1, 0, 0, {{0}, -1, -1, 0}};   // mutex_id = 1
-Mutex mutexInput = {2, false, -1, 0, 0, {{0}, -1, -1, 0}};  // mutex_id = 2
-Mutex mutexOutput = {3, false, -1, 0, 0, {{0}, -1, -1, 0}}; // mutex_id = 3
+// Initialize mutexes with explicit braces for PriorityQueue struct
+Mutex mutexFile = {1, false, -1, 0, 0, {NULL, NULL, NULL, NULL, 0, 0, 0}};   // mutex_id = 1
+Mutex mutexInput = {2, false, -1, 0, 0, {NULL, NULL, NULL, NULL, 0, 0, 0}};  // mutex_id = 2
+Mutex mutexOutput = {3, false, -1, 0, 0, {NULL, NULL, NULL, NULL, 0, 0, 0}}; // mutex_id = 3
 
 // External mutex array for resource ordering
 Mutex* mutexes[] = {&mutexFile, &mutexInput, &mutexOutput};
 int num_mutexes = 3;
 
+// Mutexes by resource index, in the order of SimulationState.mutexes
+Mutex* mutexByIndex[] = {&mutexInput, &mutexFile, &mutexOutput};
+
 // Initialize mutexes and their blocked queues
 void initMutexes() {
     mutexFile.locked = false;
@@ -26,9 +29,9 @@ void initMutexes() {
     mutexOutput.ownerPID = -1;
     mutexOutput.hold_cycles = 0;
     mutexOutput.preemption_flag = 0;
-    initializeQueue(&mutexFile.blockedQueue);
-    initializeQueue(&mutexInput.blockedQueue);
-    initializeQueue(&mutexOutput.blockedQueue);
+    initializePriorityQueue(&mutexFile.blockedQueue);
+    initializePriorityQueue(&mutexInput.blockedQueue);
+    initializePriorityQueue(&mutexOutput.blockedQueue);
 }
 
 // Check if a process owns a specific mutex
@@ -42,7 +45,7 @@ bool ownsMutex(int pid, int mutex_id) {
 }
 
 // Wait on a mutex
-bool semWait(Mutex* mutex, int pid, char (*memory)[60][100]) {
+bool semWait(Mutex* mutex, int pid) {
     if (pid <= 0) {
         printf("Invalid PID %d, ignoring semWait\n", pid);
         return false;
@@ -60,7 +63,7 @@ bool semWait(Mutex* mutex, int pid, char (*memory)[60][100]) {
         printf("PID %d acquired mutex (ID=%d)\n", pid, mutex->mutex_id);
         return true;
     } else {
-        enqueue(&mutex->blockedQueue, pid);
+        priorityEnqueue(&mutex->blockedQueue, pid, getProcessPriority(pid));
         blockProcess(pid);
         printf("PID %d blocked, waiting for mutex (ID=%d)\n", pid, mutex->mutex_id);
         return false;
@@ -126,21 +129,19 @@ bool semWait(Mutex* mutex, int pid, char (*memory)[60][100]) {
 void semSignal(Mutex* mutex) {
     printf("semSignal called for mutex (ID=%d), ownerPID=%d\n", mutex->mutex_id, mutex->ownerPID);
     if (mutex->ownerPID != -1 && mutex->locked) {
-        if (!isEmpty(&mutex->blockedQueue)) {
-            int unblockedPID = dequeueHighestPriority(&mutex->blockedQueue);
-            int pcbIndex = findPCBStartIndex(unblockedPID);
-            if (pcbIndex == -1) {
+        if (priorityQueueSize(&mutex->blockedQueue) > 0) {
+            int unblockedPID = priorityDequeue(&mutex->blockedQueue);
+            int slot = findPCB(unblockedPID);
+            if (slot == -1) {
                 printf("PCB not found for unblocked PID %d, discarding\n", unblockedPID);
                 return;
             }
-            char stateStr[20];
-            sscanf(memory[pcbIndex + 1], "state : %s", stateStr);
-            if (strcmp(stateStr, "Terminated") == 0) {
+            if (pcbTable.state[slot] == TERMINATED) {
                 printf("PID %d already terminated, discarding\n", unblockedPID);
                 return;
             }
-            printf("Unblocking PID %d from mutex (ID=%d), remaining blockedQueue: ", unblockedPID, mutex->mutex_id);
-            printQueue(&mutex->blockedQueue); // Debug: Show remaining blockedQueue
+            printf("Unblocking PID %d from mutex (ID=%d), %d still waiting\n", unblockedPID, mutex->mutex_id,
+                   priorityQueueSize(&mutex->blockedQueue));
             mutex->ownerPID = unblockedPID;
             unblockProcess(unblockedPID);
             /*int priority = getProcessPriority(unblockedPID);
@@ -169,32 +170,37 @@ void releaseMutexOnTermination(Mutex* mutex, int pid) {
 
 // Block a process by updating its state
 void blockProcess(int pid) {
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex != -1) {
-        snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Blocked");
+    int slot = findPCB(pid);
+    if (slot != -1) {
+        update_pcb_state(slot, BLOCKED);
         printf("Process %d is now BLOCKED.\n", pid);
     }
 }
 
 // Unblock a process by updating its state
 void unblockProcess(int pid) {
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex != -1) {
-        snprintf(memory[pcbIndex + 1], MAX_LINE_LENGTH, "state : Ready");
+    int slot = findPCB(pid);
+    if (slot != -1) {
+        update_pcb_state(slot, READY);
         printf("Process %d is now UNBLOCKED.\n", pid);
     }
 }
 
 // Get the priority of a process from its PCB
 int getProcessPriority(int pid) {
-    int pcbIndex = findPCBStartIndex(pid);
-    if (pcbIndex == -1) {
+    int slot = findPCB(pid);
+    if (slot == -1) {
         printf("Process with PID %d not found!\n", pid);
         return 1; // Default priority
     }
-    int priority;
-    sscanf(memory[pcbIndex + 2], "priority : %d", &priority);
-    return priority;
+    return pcbTable.priority[slot];
+}
+
+// Re-key a process in any mutex blocked queue it waits in
+void updateBlockedPriority(int pid, int priority) {
+    for (int i = 0; i < num_mutexes; i++) {
+        priorityUpdate(&mutexes[i]->blockedQueue, pid, priority);
+    }
 }
 
 // Check for mutex preemption
@@ -11,22 +11,24 @@ typedef struct {
     int ownerPID;          // PID of the process that owns the mutex
     int hold_cycles;       // Number of cycles the mutex has been held
     int preemption_flag;   // Flag to indicate if preemption occurred
-    Queue blockedQueue;    // Queue of processes blocked on this mutex
+    PriorityQueue blockedQueue; // Processes blocked on this mutex, woken by priority
 } Mutex;
 
 // External mutexes
 extern Mutex mutexFile;
 extern Mutex mutexInput;
 extern Mutex mutexOutput;
+extern Mutex* mutexByIndex[3];
 
 // Function prototypes
 void initMutexes();
-bool semWait(Mutex* mutex, int pid, char (*memory)[60][100]);
+bool semWait(Mutex* mutex, int pid);
 void semSignal(Mutex* mutex);
 void releaseMutexOnTermination(Mutex* mutex, int pid);
 void blockProcess(int pid);
 void unblockProcess(int pid);
 int getProcessPriority(int pid);
+void updateBlockedPriority(int pid, int priority);
 void checkPreemption(Mutex* mutex);
 
 #endif
\ No newline at end of file
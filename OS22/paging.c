@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "paging.h"
+#include "arena.h"
+
+typedef struct {
+    int slot; // -1 for an empty entry
+    int page;
+    int frame;
+} TLBEntry;
+
+static int pageSize = 0;
+static int numFrames = 0;
+static int* frameSlot = NULL; // Owner of each frame, -1 when free
+static int* framePage = NULL;
+static int* freeFrames = NULL;
+static int numFreeFrames = 0;
+
+// Replacement bookkeeping. Frames are linked into intrusive lists: list 0 in
+// load order (FIFO) or use order (LRU), list n holding frames used n times (LFU).
+static ReplacementPolicy policy = PAGE_FIFO;
+static int* listPrev = NULL;
+static int* listNext = NULL;
+static int* frameList = NULL; // List a frame is on, -1 for none
+static int listHead[LFU_MAX_COUNT + 1];
+static int listTail[LFU_MAX_COUNT + 1];
+static int minCount = 1;          // LFU: lowest list that may be non-empty
+static unsigned long long* referenced = NULL; // Clock: one bit per frame
+static int hand = 0;              // Clock: next frame the hand looks at
+
+// Fully associative, replaced round robin
+static TLBEntry* tlb = NULL;
+static int tlbSize = 0;
+static int tlbNext = 0;
+
+// Frames the current instruction has touched; they are not evicted until the
+// next fetch, so pointers into them stay valid while the instruction runs
+static int pinned[MIN_FRAMES];
+static int numPinned = 0;
+
+static PagingStats stats;
+
+static const char* policyNames[] = {"fifo", "lru", "clock", "lfu"};
+
+const char* replacementPolicyName(ReplacementPolicy p) {
+    return p >= PAGE_FIFO && p <= PAGE_LFU ? policyNames[p] : "unknown";
+}
+
+int parseReplacementPolicy(const char* name) {
+    for (int i = PAGE_FIFO; i <= PAGE_LFU; i++) {
+        if (strcmp(name, policyNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int paging_enabled(void) {
+    return pageSize > 0;
+}
+
+static void releaseAllTables(void) {
+    for (int slot = 0; slot < pcbTable.capacity; slot++) {
+        PageTable* table = pcbTable.pageTable[slot];
+        if (table == NULL) continue;
+        free(table->frame);
+        free(table->text);
+        free(table->code);
+        free(table);
+        pcbTable.pageTable[slot] = NULL;
+    }
+}
+
+int paging_init(int memoryWords, int size, int tlbEntries, ReplacementPolicy replacement) {
+    releaseAllTables();
+    free(frameSlot);
+    free(framePage);
+    free(freeFrames);
+    free(tlb);
+    free(listPrev);
+    free(listNext);
+    free(frameList);
+    free(referenced);
+    frameSlot = framePage = freeFrames = NULL;
+    listPrev = listNext = frameList = NULL;
+    referenced = NULL;
+    tlb = NULL;
+    pageSize = 0;
+    memset(&stats, 0, sizeof(stats));
+    if (size == 0) return 0;
+
+    numFrames = memoryWords / size;
+    if (numFrames < MIN_FRAMES) {
+        printf("Paging needs at least %d frames: %d words hold %d pages of %d words\n",
+               MIN_FRAMES, memoryWords, numFrames, size);
+        return -1;
+    }
+    frameSlot = heap_malloc(numFrames * sizeof(int));
+    framePage = heap_malloc(numFrames * sizeof(int));
+    freeFrames = heap_malloc(numFrames * sizeof(int));
+    tlb = heap_malloc(tlbEntries * sizeof(TLBEntry));
+    listPrev = heap_malloc(numFrames * sizeof(int));
+    listNext = heap_malloc(numFrames * sizeof(int));
+    frameList = heap_malloc(numFrames * sizeof(int));
+    referenced = heap_calloc((numFrames + 63) / 64, sizeof(unsigned long long));
+    if (!frameSlot || !framePage || !freeFrames || !tlb || !listPrev || !listNext || !frameList || !referenced) {
+        printf("memory error for %d frames\n", numFrames);
+        return -1;
+    }
+    numFreeFrames = 0;
+    for (int frame = numFrames - 1; frame >= 0; frame--) {
+        frameSlot[frame] = -1;
+        frameList[frame] = -1;
+        freeFrames[numFreeFrames++] = frame;
+    }
+    for (int i = 0; i <= LFU_MAX_COUNT; i++) {
+        listHead[i] = listTail[i] = -1;
+    }
+    minCount = 1;
+    policy = replacement;
+    for (int i = 0; i < tlbEntries; i++) {
+        tlb[i].slot = -1;
+    }
+    tlbSize = tlbEntries;
+    tlbNext = 0;
+    hand = 0;
+    numPinned = 0;
+    pageSize = size;
+    stats.frames = numFrames;
+    return 0;
+}
+
+int paging_map(int slot, int words) {
+    PageTable* table = heap_calloc(1, sizeof(PageTable));
+    if (table == NULL) return -1;
+    table->pages = (words + pageSize - 1) / pageSize;
+    int capacity = table->pages * pageSize;
+    table->frame = heap_malloc(table->pages * sizeof(int));
+    table->text = heap_calloc(capacity, MAX_LINE_LENGTH);
+    table->code = heap_calloc(capacity, sizeof(Instruction));
+    if (!table->frame || !table->text || !table->code) {
+        printf("memory error for a page table of %d pages\n", table->pages);
+        free(table->frame);
+        free(table->text);
+        free(table->code);
+        free(table);
+        return -1;
+    }
+    for (int page = 0; page < table->pages; page++) {
+        table->frame[page] = -1;
+    }
+    for (int i = 0; i < capacity; i++) {
+        table->code[i].type = INVALID;
+    }
+    pcbTable.pageTable[slot] = table;
+    return 0;
+}
+
+static void tlbForget(int slot, int page) {
+    for (int i = 0; i < tlbSize; i++) {
+        if (tlb[i].slot == slot && (page < 0 || tlb[i].page == page)) tlb[i].slot = -1;
+    }
+}
+
+static int tlbFind(int slot, int page) {
+    for (int i = 0; i < tlbSize; i++) {
+        if (tlb[i].slot == slot && tlb[i].page == page) return tlb[i].frame;
+    }
+    return -1;
+}
+
+static void tlbInsert(int slot, int page, int frame) {
+    tlb[tlbNext].slot = slot;
+    tlb[tlbNext].page = page;
+    tlb[tlbNext].frame = frame;
+    tlbNext = (tlbNext + 1) % tlbSize;
+}
+
+static int isPinned(int frame) {
+    for (int i = 0; i < numPinned; i++) {
+        if (pinned[i] == frame) return 1;
+    }
+    return 0;
+}
+
+static void pin(int frame) {
+    if (!isPinned(frame) && numPinned < MIN_FRAMES) pinned[numPinned++] = frame;
+}
+
+static void listAppend(int list, int frame) {
+    listPrev[frame] = listTail[list];
+    listNext[frame] = -1;
+    if (listTail[list] >= 0) listNext[listTail[list]] = frame;
+    else listHead[list] = frame;
+    listTail[list] = frame;
+    frameList[frame] = list;
+}
+
+static void listRemove(int frame) {
+    int list = frameList[frame];
+    if (list < 0) return;
+    if (listPrev[frame] >= 0) listNext[listPrev[frame]] = listNext[frame];
+    else listHead[list] = listNext[frame];
+    if (listNext[frame] >= 0) listPrev[listNext[frame]] = listPrev[frame];
+    else listTail[list] = listPrev[frame];
+    frameList[frame] = -1;
+}
+
+static void setReferenced(int frame, int on) {
+    if (on) referenced[frame / 64] |= 1ULL << (frame % 64);
+    else referenced[frame / 64] &= ~(1ULL << (frame % 64));
+}
+
+static int isReferenced(int frame) {
+    return (referenced[frame / 64] >> (frame % 64)) & 1;
+}
+
+// A page was just copied into the frame
+static void frameLoaded(int frame) {
+    switch (policy) {
+        case PAGE_FIFO:
+        case PAGE_LRU:
+            listAppend(0, frame);
+            break;
+        case PAGE_CLOCK:
+            setReferenced(frame, 1);
+            break;
+        case PAGE_LFU:
+            listAppend(1, frame);
+            minCount = 1;
+            break;
+    }
+}
+
+// The resident page in the frame was accessed again
+static void frameUsed(int frame) {
+    switch (policy) {
+        case PAGE_FIFO:
+            break;
+        case PAGE_LRU:
+            listRemove(frame);
+            listAppend(0, frame);
+            break;
+        case PAGE_CLOCK:
+            setReferenced(frame, 1);
+            break;
+        case PAGE_LFU: {
+            int count = frameList[frame];
+            if (count == LFU_MAX_COUNT) break;
+            listRemove(frame);
+            listAppend(count + 1, frame);
+            if (count == minCount && listHead[count] < 0) minCount = count + 1;
+            break;
+        }
+    }
+}
+
+static void frameEmptied(int frame) {
+    listRemove(frame);
+    setReferenced(frame, 0);
+}
+
+// First unpinned frame of a list
+static int firstUnpinned(int list) {
+    int frame = listHead[list];
+    while (frame >= 0 && isPinned(frame)) frame = listNext[frame];
+    return frame;
+}
+
+// Called with every frame in use and at most MIN_FRAMES - 1 of them pinned
+static int chooseVictim(void) {
+    switch (policy) {
+        case PAGE_FIFO:
+        case PAGE_LRU:
+            return firstUnpinned(0);
+        case PAGE_CLOCK:
+            for (;;) {
+                int frame = hand;
+                hand = (hand + 1) % numFrames;
+                if (isPinned(frame)) continue;
+                if (!isReferenced(frame)) return frame;
+                setReferenced(frame, 0);
+            }
+        case PAGE_LFU:
+            // Lists below minCount are empty; released frames may have
+            // emptied minCount's list too, so move up past empty lists
+            while (listHead[minCount] < 0 && minCount < LFU_MAX_COUNT) minCount++;
+            for (int count = minCount; count <= LFU_MAX_COUNT; count++) {
+                int frame = firstUnpinned(count);
+                if (frame >= 0) return frame;
+            }
+            break;
+    }
+    return -1;
+}
+
+// Copy a resident page back to its owner's image and free the frame
+static void evict(int frame) {
+    int slot = frameSlot[frame];
+    int page = framePage[frame];
+    PageTable* table = pcbTable.pageTable[slot];
+    memcpy(table->text[page * pageSize], memory[frame * pageSize], (size_t)pageSize * MAX_LINE_LENGTH);
+    memcpy(&table->code[page * pageSize], &decoded[frame * pageSize], pageSize * sizeof(Instruction)); // Variable values
+    table->frame[page] = -1;
+    tlbForget(slot, page);
+    frameEmptied(frame);
+    frameSlot[frame] = -1;
+    stats.evictions++;
+    stats.framesInUse--;
+}
+
+static int pageIn(int slot, int page) {
+    int frame;
+    if (numFreeFrames > 0) {
+        frame = freeFrames[--numFreeFrames];
+    } else {
+        frame = chooseVictim();
+        evict(frame);
+    }
+    PageTable* table = pcbTable.pageTable[slot];
+    int first = frame * pageSize;
+    memcpy(memory[first], table->text[page * pageSize], (size_t)pageSize * MAX_LINE_LENGTH);
+    memcpy(&decoded[first], &table->code[page * pageSize], pageSize * sizeof(Instruction));
+    markMemoryDirty(first, pageSize);
+    table->frame[page] = frame;
+    frameSlot[frame] = slot;
+    framePage[frame] = page;
+    frameLoaded(frame);
+    stats.pageFaults++;
+    stats.framesInUse++;
+    return frame;
+}
+
+int paging_translate(int slot, int address) {
+    int page = address / pageSize;
+    stats.translations++;
+    int frame = tlbFind(slot, page);
+    if (frame >= 0) {
+        stats.tlbHits++;
+        frameUsed(frame);
+    } else {
+        stats.tlbMisses++;
+        frame = pcbTable.pageTable[slot]->frame[page];
+        if (frame < 0) frame = pageIn(slot, page);
+        else frameUsed(frame);
+        tlbInsert(slot, page, frame);
+    }
+    pin(frame);
+    return frame * pageSize + address % pageSize;
+}
+
+int paging_fetch(int slot, int address) {
+    numPinned = 0;
+    return paging_translate(slot, address);
+}
+
+int paging_lookup(int slot, int address) {
+    PageTable* table = pcbTable.pageTable[slot];
+    if (table == NULL) return -1;
+    int frame = table->frame[address / pageSize];
+    return frame < 0 ? -1 : frame * pageSize + address % pageSize;
+}
+
+void paging_release(int slot) {
+    PageTable* table = pcbTable.pageTable[slot];
+    if (table == NULL) return;
+    for (int page = 0; page < table->pages; page++) {
+        int frame = table->frame[page];
+        if (frame < 0) continue;
+        int first = frame * pageSize;
+        for (int i = first; i < first + pageSize; i++) {
+            memory[i][0] = '\0';
+            decoded[i].type = INVALID;
+        }
+        markMemoryDirty(first, pageSize);
+        frameEmptied(frame);
+        frameSlot[frame] = -1;
+        freeFrames[numFreeFrames++] = frame;
+        stats.framesInUse--;
+    }
+    tlbForget(slot, -1);
+    numPinned = 0;
+    free(table->frame);
+    free(table->text);
+    free(table->code);
+    free(table);
+    pcbTable.pageTable[slot] = NULL;
+}
+
+int paging_free_words(void) {
+    return numFreeFrames * pageSize;
+}
+
+void paging_stats(PagingStats* out) {
+    *out = stats;
+}
@@ -0,0 +1,54 @@
+// paging.h
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "pcb.h"
+#include "instruction.h"
+
+#define MIN_FRAMES 4 // An instruction touches its own page and at most three variable pages
+#define LFU_MAX_COUNT 255 // Use counts saturate here
+
+// Which resident page gives up its frame (the 'page_policy' setting). Every
+// policy does O(1) work per access; choosing a victim skips at most the few
+// pinned frames (and, for Clock, clears reference bits as the hand passes).
+typedef enum {
+    PAGE_FIFO,  // Loaded earliest
+    PAGE_LRU,   // Used least recently (intrusive list, most recent at the tail)
+    PAGE_CLOCK, // Second chance: reference bit per frame and a rotating hand
+    PAGE_LFU    // Used least often (one list per use count), oldest first on ties
+} ReplacementPolicy;
+
+// Per-process page table, kept in the PCB (pcbTable.pageTable). The table also
+// holds the process image: a page is copied into a frame on first touch and
+// its words are copied back when the frame is taken for another page.
+typedef struct PageTable {
+    int pages;
+    int* frame;                    // Frame holding each page, -1 when not resident
+    char (*text)[MAX_LINE_LENGTH]; // Backing copy of the image, pages * page size words
+    Instruction* code;
+} PageTable;
+
+typedef struct {
+    long translations;
+    long tlbHits;
+    long tlbMisses;
+    long pageFaults; // Page copied into a frame, first touch or reload
+    long evictions;  // Resident page pushed out to make room
+    int framesInUse;
+    int frames;
+} PagingStats;
+
+// Memory is split into memoryWords / pageSize frames; pageSize 0 turns paging off
+int paging_init(int memoryWords, int pageSize, int tlbEntries, ReplacementPolicy policy); // -1 if it cannot be set up
+int paging_enabled(void);
+int paging_map(int slot, int words);     // Page table for a new process image, -1 on failure
+void paging_release(int slot);           // Frees the frames and the page table
+int paging_fetch(int slot, int address); // Physical word of an instruction; starts a new instruction
+int paging_translate(int slot, int address); // Physical word, faulting the page in if needed
+int paging_lookup(int slot, int address);    // Physical word if resident, else -1; not counted
+int paging_free_words(void);
+void paging_stats(PagingStats* stats);
+const char* replacementPolicyName(ReplacementPolicy policy);
+int parseReplacementPolicy(const char* name); // ReplacementPolicy value, -1 if unknown
+
+#endif
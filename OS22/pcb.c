@@ -2,67 +2,214 @@
 #include <stdlib.h>
 #include <string.h>
 #include "pcb.h"
+#include "instruction.h"
+#include "paging.h"
+#include "mutex.h"
+#include "arena.h"
 
-PCB* create_pcb(int process_id, int priority, int memory_lower, int memory_upper) {
-    PCB* pcb = (PCB*)malloc(sizeof(PCB));
-    if (pcb == NULL) {
-        printf("memory error for PCB\n");
-        return NULL;
-    }
-    pcb->process_id = process_id;
-    pcb->state = NEW;
-    pcb->priority = priority;
-    pcb->program_counter = 0;
-    pcb->memory_lower_bound = memory_lower;
-    pcb->memory_upper_bound = memory_upper;
-    
-    printf("Created PCB: PID=%d, Priority=%d, Memory[%d, %d]\n", 
-            pcb->process_id, pcb->priority, pcb->memory_lower_bound, pcb->memory_upper_bound);
-    
-    return pcb;
+PCBTable pcbTable;
+
+// Direct-mapped PID -> slot index (-1 when the PID has no PCB), grown on demand.
+// Slots never move, so relocating a process image does not touch the index.
+static int* pidIndex = NULL;
+static int pidIndexSize = 0;
+
+// Stack of unused slots so create_pcb does not scan the table
+static int* freeSlots = NULL;
+static int numFreeSlots = 0; // Filled by reset_pcb_table
+
+static bool reservePidIndex(int pid) {
+    if (pid < pidIndexSize) return true;
+    int newSize = pidIndexSize ? pidIndexSize : 16;
+    while (newSize <= pid) newSize *= 2;
+    int* grown = heap_realloc(pidIndex, newSize * sizeof(int));
+    if (grown == NULL) {
+        printf("memory error for PID index\n");
+        return false;
+    }
+    for (int i = pidIndexSize; i < newSize; i++) {
+        grown[i] = -1;
+    }
+    pidIndex = grown;
+    pidIndexSize = newSize;
+    return true;
 }
 
-void update_pcb_state(PCB* pcb, ProcessState new_state) {
-    if (pcb) {
-        pcb->state = new_state;
+int create_pcb(int process_id, int priority, int memory_lower, int memory_upper) {
+    if (process_id <= 0 || !reservePidIndex(process_id)) return -1;
+    if (pidIndex[process_id] != -1) {
+        printf("PID %d already has a PCB\n", process_id);
+        return -1;
+    }
+    if (numFreeSlots == 0) {
+        printf("Process table full, cannot create PCB for PID %d\n", process_id);
+        return -1;
     }
+    int slot = freeSlots[--numFreeSlots];
+    pidIndex[process_id] = slot;
+    pcbTable.used[slot] = true;
+    pcbTable.pid[slot] = process_id;
+    pcbTable.state[slot] = READY;
+    pcbTable.priority[slot] = priority;
+    pcbTable.pc[slot] = memory_lower + PCB_WORDS;
+    pcbTable.lowerBound[slot] = memory_lower;
+    pcbTable.upperBound[slot] = memory_upper;
+    pcbTable.variables[slot] = MIN_VARIABLE_WORDS;
+    pcbTable.quantumUsed[slot] = 0;
+    pcbTable.deadlockAttempts[slot] = 0;
+    pcbTable.swapOffset[slot] = -1;
+    pcbTable.pageTable[slot] = NULL;
+    pcbTable.cpu[slot] = 0;
+    pcbTable.affinity[slot] = ~0ULL;
+    pcbTable.count++;
+    return slot;
 }
 
-void update_pcb_priority(PCB* pcb, int new_priority) {
-    if (pcb) {
-        pcb->priority = new_priority;
+void update_pcb_state(int slot, ProcessState new_state) {
+    if (slot >= 0) {
+        pcbTable.state[slot] = new_state;
     }
 }
 
-void update_pcb_program_counter(PCB* pcb, int new_pc) {
-    if (pcb) {
-        pcb->program_counter = new_pc;
+void update_pcb_priority(int slot, int new_priority) {
+    if (slot >= 0) {
+        pcbTable.priority[slot] = new_priority;
+        updateBlockedPriority(pcbTable.pid[slot], new_priority);
     }
 }
 
-void print_pcb(PCB* pcb) {
-    if (pcb) {
-        printf("PCB: ID=%d, State=%d, Priority=%d, PC=%d, Memory=[%d,%d]\n",
-               pcb->process_id, pcb->state, pcb->priority, pcb->program_counter,
-               pcb->memory_lower_bound, pcb->memory_upper_bound);
+void update_pcb_program_counter(int slot, int new_pc) {
+    if (slot >= 0) {
+        pcbTable.pc[slot] = new_pc;
     }
 }
 
-void free_pcb(PCB* pcb) {
-    if (pcb) {
-        free(pcb);
+void print_pcb(int slot) {
+    if (slot >= 0 && pcbTable.used[slot]) {
+        printf("PCB: ID=%d, State=%s, Priority=%d, PC=%d, Memory=[%d,%d]\n",
+               pcbTable.pid[slot], processStateName(pcbTable.state[slot]), pcbTable.priority[slot],
+               pcbTable.pc[slot], pcbTable.lowerBound[slot], pcbTable.upperBound[slot]);
     }
 }
 
-int findPCBStartIndex(int pid) {
-    for (int i = 0; i < MEMORY_SIZE; i++) {
-        if (strncmp(memory[i], "pid", 3) == 0) {
-            int storedPid;
-            sscanf(memory[i], "pid : %d", &storedPid);
-            if (storedPid == pid) {
-                return i;
-            }
-        }
-    }
-    return -1;
+void free_pcb(int slot) {
+    if (slot >= 0 && pcbTable.used[slot]) {
+        pidIndex[pcbTable.pid[slot]] = -1;
+        pcbTable.used[slot] = false;
+        pcbTable.count--;
+        freeSlots[numFreeSlots++] = slot;
+    }
+}
+
+// (Re)allocate the slot arrays for n slots, zeroed
+static void allocatePCBTable(int n) {
+    free(pcbTable.used);
+    free(pcbTable.pid);
+    free(pcbTable.state);
+    free(pcbTable.priority);
+    free(pcbTable.pc);
+    free(pcbTable.lowerBound);
+    free(pcbTable.upperBound);
+    free(pcbTable.variables);
+    free(pcbTable.quantumUsed);
+    free(pcbTable.deadlockAttempts);
+    free(pcbTable.swapOffset);
+    free(pcbTable.pageTable);
+    free(pcbTable.cpu);
+    free(pcbTable.affinity);
+    free(freeSlots);
+    pcbTable.used = heap_calloc(n, sizeof(bool));
+    pcbTable.pid = heap_calloc(n, sizeof(int));
+    pcbTable.state = heap_calloc(n, sizeof(ProcessState));
+    pcbTable.priority = heap_calloc(n, sizeof(int));
+    pcbTable.pc = heap_calloc(n, sizeof(int));
+    pcbTable.lowerBound = heap_calloc(n, sizeof(int));
+    pcbTable.upperBound = heap_calloc(n, sizeof(int));
+    pcbTable.variables = heap_calloc(n, sizeof(int));
+    pcbTable.quantumUsed = heap_calloc(n, sizeof(int));
+    pcbTable.deadlockAttempts = heap_calloc(n, sizeof(int));
+    pcbTable.swapOffset = heap_calloc(n, sizeof(long));
+    pcbTable.pageTable = heap_calloc(n, sizeof(PageTable*));
+    pcbTable.cpu = heap_calloc(n, sizeof(int));
+    pcbTable.affinity = heap_calloc(n, sizeof(unsigned long long));
+    freeSlots = heap_calloc(n, sizeof(int));
+    if (!pcbTable.used || !pcbTable.pid || !pcbTable.state || !pcbTable.priority || !pcbTable.pc ||
+        !pcbTable.lowerBound || !pcbTable.upperBound || !pcbTable.variables || !pcbTable.quantumUsed ||
+        !pcbTable.deadlockAttempts || !pcbTable.swapOffset || !pcbTable.pageTable || !pcbTable.cpu ||
+        !pcbTable.affinity || !freeSlots) {
+        printf("memory error for process table of %d slots\n", n);
+        exit(1);
+    }
+    pcbTable.capacity = n;
+}
+
+void reset_pcb_table(void) {
+    if (pcbTable.capacity != limits.maxProcesses) {
+        allocatePCBTable(limits.maxProcesses);
+    } else {
+        memset(pcbTable.used, 0, pcbTable.capacity * sizeof(bool));
+    }
+    pcbTable.count = 0;
+    for (int i = 0; i < pidIndexSize; i++) {
+        pidIndex[i] = -1;
+    }
+    // Hand out low slots first
+    numFreeSlots = 0;
+    for (int slot = pcbTable.capacity - 1; slot >= 0; slot--) {
+        freeSlots[numFreeSlots++] = slot;
+    }
+}
+
+int findPCB(int pid) {
+    if (pid <= 0 || pid >= pidIndexSize) return -1;
+    return pidIndex[pid];
+}
+
+const char* processStateName(ProcessState state) {
+    switch (state) {
+        case NEW: return "New";
+        case READY: return "Ready";
+        case RUNNING: return "Running";
+        case BLOCKED: return "Blocked";
+        case TERMINATED: return "Terminated";
+    }
+    return "Unknown";
+}
+
+// Replace a memory word, flagging it for the view only when its text changes.
+// In paging mode the word is skipped unless its page is resident.
+static void renderWord(int slot, int address, const char* text) {
+    if (paging_enabled()) {
+        address = paging_lookup(slot, address);
+        if (address < 0) return;
+    }
+    if (strcmp(memory[address], text) != 0) {
+        snprintf(memory[address], MAX_LINE_LENGTH, "%s", text);
+        markMemoryDirty(address, 1);
+    }
+}
+
+// Write the textual PCB view into the first words of the process's memory region
+void renderPCB(int slot) {
+    if (slot < 0 || !pcbTable.used[slot] || pcbTable.swapOffset[slot] >= 0) return;
+    int base = pcbTable.lowerBound[slot];
+    char text[MAX_LINE_LENGTH];
+    snprintf(text, sizeof(text), "pid : %d", pcbTable.pid[slot]);
+    renderWord(slot, base, text);
+    snprintf(text, sizeof(text), "state : %s", processStateName(pcbTable.state[slot]));
+    renderWord(slot, base + 1, text);
+    snprintf(text, sizeof(text), "priority : %d", pcbTable.priority[slot]);
+    renderWord(slot, base + 2, text);
+    snprintf(text, sizeof(text), "pc : %d", pcbTable.pc[slot]);
+    renderWord(slot, base + 3, text);
+    snprintf(text, sizeof(text), "lowerBound : %d", pcbTable.lowerBound[slot]);
+    renderWord(slot, base + 4, text);
+    snprintf(text, sizeof(text), "upperBound : %d", pcbTable.upperBound[slot]);
+    renderWord(slot, base + 5, text);
+}
+
+void renderPCBs(void) {
+    for (int slot = 0; slot < pcbTable.capacity; slot++) {
+        renderPCB(slot);
+    }
 }
\ No newline at end of file
@@ -2,8 +2,13 @@
 #ifndef PCB_H
 #define PCB_H
 
-#define MEMORY_SIZE 60
+#include <stdbool.h>
+#include "config.h"
+
 #define MAX_LINE_LENGTH 100
+#define PCB_WORDS 6 // pid, state, priority, pc, lowerBound, upperBound
+
+struct PageTable; // paging.h
 
 // Enum for process states
 typedef enum {
@@ -14,27 +19,50 @@ typedef enum {
     TERMINATED
 } ProcessState;
 
-// Structure for Process Control Block
-typedef struct PCB {
-    int process_id;
-    ProcessState state;
-    int priority;
-    int program_counter;
-    int memory_lower_bound;
-    int memory_upper_bound;
-} PCB;
+// Process table kept as parallel arrays indexed by slot. This is the source of
+// truth for every PCB; the "pid : 1" style words in memory are only a rendered
+// view, produced by renderPCB when the GUI or a dump asks for it.
+// The arrays hold limits.maxProcesses slots and are allocated by reset_pcb_table.
+typedef struct {
+    bool* used;
+    int* pid;
+    ProcessState* state;
+    int* priority;
+    int* pc;
+    int* lowerBound;
+    int* upperBound;
+    int* variables;        // Variable words at the top of the image
+    int* quantumUsed;      // Instructions run in the current MLFQ level
+    int* deadlockAttempts; // Times unblocked by deadlock recovery
+    long* swapOffset;      // Backing store record while swapped out, -1 when resident
+    struct PageTable** pageTable; // Paging mode only; bounds and PC are then page-table addresses
+    int* cpu;              // Core whose run queues hold the process (SMP mode)
+    unsigned long long* affinity; // Cores the process may run on, bit n = core n
+    int count;
+    int capacity;
+} PCBTable;
+
+// External memory array (limits.memorySize words) and process table
+extern char (*memory)[MAX_LINE_LENGTH];
+extern PCBTable pcbTable;
 
-// External memory array
-extern char memory[MEMORY_SIZE][MAX_LINE_LENGTH];
+// One bit per memory word written since the memory view last synced;
+// anything that writes memory[] calls markMemoryDirty for those words
+extern unsigned long long* memoryDirty;
+void markMemoryDirty(int first, int count);
 
 // Function declarations
-PCB* create_pcb(int process_id, int priority, int memory_lower, int memory_upper);
-void update_pcb_state(PCB* pcb, ProcessState new_state);
-void update_pcb_priority(PCB* pcb, int new_priority);
-void update_pcb_program_counter(PCB* pcb, int new_pc);
-void free_pcb(PCB* pcb);
+int create_pcb(int process_id, int priority, int memory_lower, int memory_upper); // Returns slot or -1
+void update_pcb_state(int slot, ProcessState new_state);
+void update_pcb_priority(int slot, int new_priority);
+void update_pcb_program_counter(int slot, int new_pc);
+void free_pcb(int slot);
+void reset_pcb_table(void);
 void freeProgram(int pid); // Added declaration for freeProgram
-void print_pcb(PCB* pcb);
-int findPCBStartIndex(int pid);
+void print_pcb(int slot);
+int findPCB(int pid);
+const char* processStateName(ProcessState state);
+void renderPCB(int slot);
+void renderPCBs(void);
 
 #endif
\ No newline at end of file
@@ -1,15 +1,49 @@
 #include "queue.h"
 #include "pcb.h"
+#include "config.h"
+#include "arena.h"
+#include "log.h"
 #include <stdio.h>
+#include <stdlib.h>
 
-// Function to initialize the queue
+// Make sure 'pid' has link entries, growing the arrays geometrically
+static void reserveLinks(Queue* q, int pid) {
+    if (pid < q->linkCapacity) return;
+    // queue_capacity is only a first guess now; PIDs rarely go far past the
+    // process table size, so do not touch more link entries than that up front
+    int capacity = q->linkCapacity;
+    if (capacity == 0) {
+        capacity = limits.queueCapacity < limits.maxProcesses + 1 ? limits.queueCapacity : limits.maxProcesses + 1;
+        if (capacity < 16) capacity = 16;
+    }
+    while (capacity <= pid) capacity *= 2;
+    int* next = heap_realloc(q->next, capacity * sizeof(int));
+    int* prev = next ? heap_realloc(q->prev, capacity * sizeof(int)) : NULL;
+    if (next == NULL || prev == NULL) {
+        printf("memory error for queue links of %d PIDs\n", capacity);
+        exit(1);
+    }
+    for (int i = q->linkCapacity; i < capacity; i++) {
+        prev[i] = -1;
+    }
+    q->next = next;
+    q->prev = prev;
+    q->linkCapacity = capacity;
+}
+
+// Function to initialize the queue. Link storage is kept across
+// re-initialization; the Queue must start zeroed (static or memset). Only the
+// current members are unlinked, so clearing a queue costs its size.
 void initializeQueue(Queue* q) {
-    q->front = -1;
-    q->rear = -1;
-    q->size = 0;
-    for (int i = 0; i < MAX_QUEUE_SIZE; i++) {
-        q->items[i] = 0;
+    for (int pid = q->head; pid > 0;) {
+        int next = q->next[pid];
+        q->prev[pid] = -1;
+        pid = next;
     }
+    q->head = 0;
+    q->tail = 0;
+    q->size = 0;
+    reserveLinks(q, 0);
 }
 
 // Function to check if the queue is empty
@@ -17,70 +51,70 @@ bool isEmpty(Queue* q) {
     return (q->size == 0);
 }
 
-// Function to check if the queue is full
-bool isFull(Queue* q) {
-    return (q->size == MAX_QUEUE_SIZE);
-}
-
 // Function to check if a PID is in the queue
 bool isInQueue(Queue* q, int pid) {
-    if (isEmpty(q)) return false;
-    for (int i = q->front; i < q->front + q->size; i++) {
-        int index = i % MAX_QUEUE_SIZE;
-        if (q->items[index] == pid) {
-            return true;
-        }
-    }
-    return false;
+    return pid > 0 && pid < q->linkCapacity && q->prev[pid] != -1;
+}
+
+static void linkAfter(Queue* q, int after, int pid) {
+    reserveLinks(q, pid);
+    int next = after ? q->next[after] : q->head;
+    q->prev[pid] = after;
+    q->next[pid] = next;
+    if (after) q->next[after] = pid;
+    else q->head = pid;
+    if (next) q->prev[next] = pid;
+    else q->tail = pid;
+    q->size++;
+}
+
+static void unlinkPid(Queue* q, int pid) {
+    int prev = q->prev[pid];
+    int next = q->next[pid];
+    if (prev) q->next[prev] = next;
+    else q->head = next;
+    if (next) q->prev[next] = prev;
+    else q->tail = prev;
+    q->prev[pid] = -1;
+    q->size--;
 }
 
 // Function to add an element to the queue (Enqueue operation)
 void enqueue(Queue* q, int pid) {
-    if (isFull(q)) {
-        printf("Queue is full, cannot enqueue PID %d\n", pid);
+    if (pid <= 0) {
+        log_printf("Invalid PID %d, cannot enqueue\n", pid);
         return;
     }
     if (isInQueue(q, pid)) {
-        printf("PID %d already in queue, skipping enqueue\n", pid);
+        log_printf("PID %d already in queue, skipping enqueue\n", pid);
         return;
     }
-    if (isEmpty(q)) {
-        q->front = 0;
-    }
-    q->rear = (q->rear + 1) % MAX_QUEUE_SIZE;
-    q->items[q->rear] = pid;
-    q->size++;
+    linkAfter(q, q->tail, pid);
 }
 
 // Function to remove an element from the queue (Dequeue operation)
 int dequeue(Queue* q) {
     if (isEmpty(q)) {
-        printf("Queue is empty, cannot dequeue\n");
+        log_printf("Queue is empty, cannot dequeue\n");
         return -1;
     }
-    int pid = q->items[q->front];
-    q->front = (q->front + 1) % MAX_QUEUE_SIZE;
-    q->size--;
-    if (isEmpty(q)) {
-        q->front = -1;
-        q->rear = -1;
-    }
+    int pid = q->head;
+    unlinkPid(q, pid);
     return pid;
 }
 
-void enqueueBack(Queue* q, int pid){
-    q->front = (q->front - 1) % MAX_QUEUE_SIZE;
-    q->size++;
-    q->items[q->front] = pid;
+void enqueueBack(Queue* q, int pid) {
+    if (pid <= 0 || isInQueue(q, pid)) return;
+    linkAfter(q, 0, pid);
 }
 
 // Function to get the element at the front of the queue (Peek operation)
 int peek(Queue* q) {
     if (isEmpty(q)) {
-        printf("Queue is empty\n");
+        log_printf("Queue is empty\n");
         return -1;
     }
-    return q->items[q->front];
+    return q->head;
 }
 
 // Function to count elements in the queue
@@ -88,6 +122,22 @@ int countQueueElements(Queue* q) {
     return q->size;
 }
 
+int queueFirst(Queue* q) {
+    return q->head;
+}
+
+int queueNext(Queue* q, int pid) {
+    return q->next[pid];
+}
+
+int queueLast(Queue* q) {
+    return q->tail;
+}
+
+int queuePrev(Queue* q, int pid) {
+    return q->prev[pid];
+}
+
 // Function to print the current queue
 void printQueue(Queue* q) {
     if (isEmpty(q)) {
@@ -95,141 +145,194 @@ void printQueue(Queue* q) {
         return;
     }
     printf("Current Queue: ");
-    int i = q->front;
-    for (int count = 0; count < q->size; count++) {
-        printf("%d ", q->items[i]);
-        i = (i + 1) % MAX_QUEUE_SIZE;
+    for (int pid = q->head; pid > 0; pid = q->next[pid]) {
+        printf("%d ", pid);
     }
     printf("\n");
 }
 
 // Function to remove a specific PID from the queue
 bool removeFromQueue(Queue* q, int pid) {
-    if (isEmpty(q)) {
+    if (!isInQueue(q, pid)) {
         return false;
     }
-    int pos = -1;
-    for (int i = q->front; i < q->front + q->size; i++) {
-        int index = i % MAX_QUEUE_SIZE;
-        if (q->items[index] == pid) {
-            pos = index;
-            break;
-        }
+    unlinkPid(q, pid);
+    return true;
+}
+
+// Function to dequeue a specific PID
+void dequeueByPID(Queue* q, int pid) {
+    removeFromQueue(q, pid);
+}
+
+// Make sure 'pid' has heap entries; the heap never holds more members than
+// there are PIDs with entries, so it grows along with them
+static void reservePriorityLinks(PriorityQueue* q, int pid) {
+    if (pid < q->linkCapacity) return;
+    int capacity = q->linkCapacity;
+    if (capacity == 0) {
+        capacity = limits.queueCapacity < limits.maxProcesses + 1 ? limits.queueCapacity : limits.maxProcesses + 1;
+        if (capacity < 16) capacity = 16;
     }
-    if (pos == -1) {
-        return false;
+    while (capacity <= pid) capacity *= 2;
+    int* heap = heap_realloc(q->heap, capacity * sizeof(int));
+    if (heap) q->heap = heap;
+    int* position = heap ? heap_realloc(q->position, capacity * sizeof(int)) : NULL;
+    if (position) q->position = position;
+    int* priority = position ? heap_realloc(q->priority, capacity * sizeof(int)) : NULL;
+    if (priority) q->priority = priority;
+    long* order = priority ? heap_realloc(q->order, capacity * sizeof(long)) : NULL;
+    if (order == NULL) {
+        printf("memory error for priority queue of %d PIDs\n", capacity);
+        exit(1);
     }
-    for (int i = pos; i != q->rear; i = (i + 1) % MAX_QUEUE_SIZE) {
-        int next = (i + 1) % MAX_QUEUE_SIZE;
-        q->items[i] = q->items[next];
+    q->order = order;
+    for (int i = q->linkCapacity; i < capacity; i++) {
+        position[i] = -1;
     }
-    q->rear = (q->rear - 1 + MAX_QUEUE_SIZE) % MAX_QUEUE_SIZE;
-    q->size--;
-    if (isEmpty(q)) {
-        q->front = -1;
-        q->rear = -1;
+    q->linkCapacity = capacity;
+}
+
+// Function to initialize the priority queue. Like initializeQueue, storage is
+// kept and only the current members are reset; the struct must start zeroed.
+void initializePriorityQueue(PriorityQueue* q) {
+    for (int i = 0; i < q->size; i++) {
+        q->position[q->heap[i]] = -1;
     }
-    return true;
+    q->size = 0;
+    q->nextOrder = 0;
+    reservePriorityLinks(q, 0);
 }
 
-// Function to enqueue with priority
-void enqueuePriority(Queue* q, int pid, int priority) {
-    if (isFull(q)) {
-        printf("Queue is full, cannot enqueue PID %d\n", pid);
-        return;
+int priorityQueueSize(PriorityQueue* q) {
+    return q->size;
+}
+
+bool isInPriorityQueue(PriorityQueue* q, int pid) {
+    return pid > 0 && pid < q->linkCapacity && q->position[pid] != -1;
+}
+
+// True if 'a' leaves the queue before 'b'
+static bool comesBefore(PriorityQueue* q, int a, int b) {
+    if (q->priority[a] != q->priority[b]) return q->priority[a] < q->priority[b];
+    return q->order[a] < q->order[b];
+}
+
+static void placeAt(PriorityQueue* q, int index, int pid) {
+    q->heap[index] = pid;
+    q->position[pid] = index;
+}
+
+static void siftUp(PriorityQueue* q, int index) {
+    int pid = q->heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!comesBefore(q, pid, q->heap[parent])) break;
+        placeAt(q, index, q->heap[parent]);
+        index = parent;
     }
-    if (isInQueue(q, pid)) {
-        printf("PID %d already in queue, skipping enqueuePriority\n", pid);
-        return;
+    placeAt(q, index, pid);
+}
+
+static void siftDown(PriorityQueue* q, int index) {
+    int pid = q->heap[index];
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= q->size) break;
+        if (child + 1 < q->size && comesBefore(q, q->heap[child + 1], q->heap[child])) child++;
+        if (!comesBefore(q, q->heap[child], pid)) break;
+        placeAt(q, index, q->heap[child]);
+        index = child;
     }
-    if (isEmpty(q)) {
-        q->front = 0;
-        q->rear = 0;
-        q->items[0] = pid;
-        q->size = 1;
+    placeAt(q, index, pid);
+}
+
+// Function to add a PID with its priority; it goes behind members of equal priority
+void priorityEnqueue(PriorityQueue* q, int pid, int priority) {
+    if (pid <= 0) {
+        log_printf("Invalid PID %d, cannot enqueue\n", pid);
         return;
     }
-    int i;
-    for (i = q->rear; i >= q->front; i--) {
-        int currentPID = q->items[i];
-        int currentPriority = getProcessPriority(currentPID);
-        if (currentPriority > priority) {
-            q->items[i + 1] = q->items[i];
-        } else {
-            break;
-        }
+    if (isInPriorityQueue(q, pid)) {
+        log_printf("PID %d already in queue, skipping enqueue\n", pid);
+        return;
     }
-    q->items[i + 1] = pid;
-    q->rear++;
-    q->size++;
+    reservePriorityLinks(q, pid);
+    q->priority[pid] = priority;
+    q->order[pid] = q->nextOrder++;
+    placeAt(q, q->size++, pid);
+    siftUp(q, q->size - 1);
 }
 
-// Function to dequeue the highest-priority process
-int dequeueHighestPriority(Queue* q) {
-    if (isEmpty(q)) {
-        printf("Queue is empty, cannot dequeue\n");
+// Function to remove the highest-priority PID, the oldest among equals
+int priorityDequeue(PriorityQueue* q) {
+    if (q->size == 0) {
+        log_printf("Queue is empty, cannot dequeue\n");
         return -1;
     }
-    int highestPriority = 9999; // Assume lower number = higher priority
-    int highestPriorityIndex = -1;
-    int highestPriorityPID = -1;
-    for (int i = q->front; i < q->front + q->size; i++) {
-        int index = i % MAX_QUEUE_SIZE;
-        int pid = q->items[index];
-        int priority = getProcessPriority(pid);
-        if (priority < highestPriority) {
-            highestPriority = priority;
-            highestPriorityIndex = index;
-            highestPriorityPID = pid;
-        }
-    }
-    if (highestPriorityIndex == -1) {
-        return dequeue(q); // Fallback to standard dequeue
-    }
-    for (int i = highestPriorityIndex; i != q->rear; i = (i + 1) % MAX_QUEUE_SIZE) {
-        int next = (i + 1) % MAX_QUEUE_SIZE;
-        q->items[i] = q->items[next];
+    int pid = q->heap[0];
+    priorityRemove(q, pid);
+    return pid;
+}
+
+int priorityPeek(PriorityQueue* q) {
+    return q->size > 0 ? q->heap[0] : -1;
+}
+
+int priorityOf(PriorityQueue* q, int pid) {
+    return q->priority[pid];
+}
+
+// Function to remove a specific PID from the priority queue
+bool priorityRemove(PriorityQueue* q, int pid) {
+    if (!isInPriorityQueue(q, pid)) {
+        return false;
     }
-    q->rear = (q->rear - 1 + MAX_QUEUE_SIZE) % MAX_QUEUE_SIZE;
-    q->size--;
-    if (isEmpty(q)) {
-        q->front = -1;
-        q->rear = -1;
+    int index = q->position[pid];
+    q->position[pid] = -1;
+    int last = q->heap[--q->size];
+    if (last != pid) {
+        placeAt(q, index, last);
+        siftUp(q, index);
+        siftDown(q, q->position[last]);
     }
-    return highestPriorityPID;
+    return true;
 }
 
-// Function to dequeue a specific PID
-void dequeueByPID(Queue* q, int pid) {
-    if (isEmpty(q)) return;
-    bool found = false;
-    do {
-        found = false;
-        int pos = -1;
-        for (int i = q->front; i < q->front + q->size; i++) {
-            int index = i % MAX_QUEUE_SIZE;
-            if (q->items[index] == pid) {
-                pos = index;
-                found = true;
-                break;
-            }
-        }
-        if (pos != -1) {
-            for (int i = pos; i != q->rear; i = (i + 1) % MAX_QUEUE_SIZE) {
-                int next = (i + 1) % MAX_QUEUE_SIZE;
-                q->items[i] = q->items[next];
-            }
-            q->rear = (q->rear - 1 + MAX_QUEUE_SIZE) % MAX_QUEUE_SIZE;
-            q->size--;
-            if (isEmpty(q)) {
-                q->front = -1;
-                q->rear = -1;
-            }
-        }
-    } while (found); // Remove all instances of the PID
+// Function to change a member's priority; it keeps its place among equals
+bool priorityUpdate(PriorityQueue* q, int pid, int priority) {
+    if (!isInPriorityQueue(q, pid)) {
+        return false;
+    }
+    int old = q->priority[pid];
+    q->priority[pid] = priority;
+    if (priority < old) siftUp(q, q->position[pid]);
+    else if (priority > old) siftDown(q, q->position[pid]);
+    return true;
 }
 
-// Function to insert with priority
-void insertWithPriority(Queue* q, int pid, int priority) {
-    enqueuePriority(q, pid, priority);
+// Heap sort of a copy of the heap array: taking the front off a min-heap
+// again and again leaves the members in reverse dequeue order
+void priorityInOrder(PriorityQueue* q, int* out) {
+    int n = q->size;
+    for (int i = 0; i < n; i++) out[i] = q->heap[i];
+    for (int end = n - 1; end > 0; end--) {
+        int pid = out[end];
+        out[end] = out[0];
+        int index = 0;
+        for (;;) {
+            int child = 2 * index + 1;
+            if (child >= end) break;
+            if (child + 1 < end && comesBefore(q, out[child + 1], out[child])) child++;
+            if (!comesBefore(q, out[child], pid)) break;
+            out[index] = out[child];
+            index = child;
+        }
+        out[index] = pid;
+    }
+    for (int i = 0, j = n - 1; i < j; i++, j--) {
+        int pid = out[i];
+        out[i] = out[j];
+        out[j] = pid;
+    }
 }
\ No newline at end of file
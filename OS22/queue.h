@@ -3,29 +3,59 @@
 
 #include <stdbool.h>
 
-#define MAX_QUEUE_SIZE 100  // Or any value you use throughout your code
-
+// Intrusive doubly linked list of PIDs. The links live in arrays indexed by
+// PID, grown on demand, so enqueue, dequeue, removal by PID and membership
+// tests are all O(1) and a queue has no capacity limit. A PID is in a given
+// queue at most once; it may be in several queues at the same time.
 typedef struct {
-    int items[MAX_QUEUE_SIZE];
-    int front;
-    int rear;
-    int size;  // Add size field to track number of elements
+    int* next;        // PID after each member, 0 at the tail
+    int* prev;        // PID before each member, 0 at the head, -1 for non-members
+    int linkCapacity; // PIDs below this have link entries
+    int head;         // 0 when empty; PIDs start at 1
+    int tail;
+    int size;
 } Queue;
 
 // Queue function declarations
 void initializeQueue(Queue* q);
 bool isEmpty(Queue* q);
-bool isFull(Queue* q);
+bool isInQueue(Queue* q, int pid);
 void enqueue(Queue* q, int pid);
 int dequeue(Queue* q);
-void enqueueBack(Queue* q, int pid);
+void enqueueBack(Queue* q, int pid); // Put at the front, next to be dequeued
 int peek(Queue* q);
 int countQueueElements(Queue* q);
+int queueFirst(Queue* q);            // Front PID, 0 if empty; does not complain
+int queueNext(Queue* q, int pid);    // PID after a member, 0 at the end
+int queueLast(Queue* q);             // Back PID, 0 if empty
+int queuePrev(Queue* q, int pid);    // PID before a member, 0 at the front
 void printQueue(Queue* q);
 bool removeFromQueue(Queue* q, int pid);  // Add function to remove specific PID
-void enqueuePriority(Queue* q, int pid, int priority);  // Insert sorted
-int dequeueHighestPriority(Queue* q);                   // Remove highest
-void dequeueByPID(Queue* q, int pid); 
-void insertWithPriority(Queue* q, int pid, int priority);
+void dequeueByPID(Queue* q, int pid);
+
+// Indexed binary min-heap of PIDs keyed on a cached priority (lower number =
+// higher priority), ties broken by enqueue order. Positions, keys and enqueue
+// stamps live in arrays indexed by PID and grow on demand like Queue links, so
+// enqueue, dequeue, removal and priority changes are O(log n).
+typedef struct {
+    int* heap;        // Members in heap order
+    int* position;    // Heap index of each member, -1 for non-members
+    int* priority;    // Cached priority of each member
+    long* order;      // Enqueue stamp of each member, for FIFO ties
+    int linkCapacity; // PIDs below this have entries
+    int size;
+    long nextOrder;
+} PriorityQueue;
+
+void initializePriorityQueue(PriorityQueue* q);
+int priorityQueueSize(PriorityQueue* q);
+bool isInPriorityQueue(PriorityQueue* q, int pid);
+void priorityEnqueue(PriorityQueue* q, int pid, int priority);
+int priorityDequeue(PriorityQueue* q);                     // Highest priority, oldest first
+int priorityPeek(PriorityQueue* q);                        // Next to leave, -1 if empty
+int priorityOf(PriorityQueue* q, int pid);                 // Cached priority of a member
+bool priorityRemove(PriorityQueue* q, int pid);
+bool priorityUpdate(PriorityQueue* q, int pid, int priority); // New priority for a member
+void priorityInOrder(PriorityQueue* q, int* out);            // Members in dequeue order; out holds size PIDs
 
 #endif // QUEUE_H
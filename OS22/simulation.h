@@ -0,0 +1,88 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "pcb.h"
+#include "queue.h"
+#include "mutex.h"
+#include "log.h"
+
+#define NUM_QUEUES 4 // MLFQ levels; RR and FCFS use the first
+
+typedef struct {
+    int pid;
+    ProcessState state;
+    int priority;
+    int lowerBound;
+    int upperBound;
+    int pc;
+    int arrivalTime; // New field for user-defined arrival
+    char currentInstruction[MAX_LINE_LENGTH];
+    int timeInQueue; // Time spent in queue, derived by sync_queue_view
+    int queuedAt;    // Clock when it first became ready
+    int cyclesRun;   // Instructions it has executed
+} ProcessInfo;
+
+// Panels a frontend has to redraw, accumulated in SimulationState.dirty
+enum {
+    DIRTY_OVERVIEW = 1 << 0,
+    DIRTY_PROCESSES = 1 << 1,
+    DIRTY_QUEUES = 1 << 2,
+    DIRTY_MUTEXES = 1 << 3,
+    DIRTY_MEMORY = 1 << 4,
+    DIRTY_ALL = (1 << 5) - 1
+};
+
+typedef struct {
+    ProcessInfo* processes; // limits.maxProcesses entries
+    int numProcesses;
+    int nextPid; // PIDs are never reused within a run
+    Queue readyQueue;
+    Queue blockedQueue; // Aggregate of mutex blocked queues
+    int runningPid; // PID of currently running process
+    char (*memory)[MAX_LINE_LENGTH]; // Display copy, allocated and refreshed by sync_memory_view
+    int clockCycle;
+    char schedulerType[10]; // mlfq, rr, fcfs
+    int rrQuantum;
+    struct {
+        int locked;
+        int ownerPid;
+        Queue blockedQueue;
+    } mutexes[3]; // userInput, userOutput, file
+    EventLog log; // Most recent LOG_CAPACITY events, formatted on demand
+    int waiting_for_input_pid;
+    char waiting_for_input_var[50];
+    int quiet; // Skip formatting log messages (headless batch runs)
+    int runWholeQuantum; // Run a full time quantum per scheduler call instead of one instruction
+    int stepIdleCycles; // Simulate idle cycles one at a time instead of jumping to the next event
+    int cycleLimit;     // Cycle the frontend stops at, 0 = none; idle jumps never pass it
+    long idleJumps;     // Times the clock jumped over idle cycles
+    long idleCyclesSkipped;
+    long instructionsExecuted;
+    long compactions;      // Compaction passes run
+    long wordsCompacted;   // Memory words moved by them
+    long compactionCycles; // Clock cycles charged for the moves
+    long parallelSteps;    // Core steps run on worker threads (threads > 1)
+    long serialSteps;      // Core steps run in core order with threads > 1
+    unsigned dirty; // DIRTY_* bits set since the frontend last redrew
+} SimulationState;
+
+// Frontend hooks, implemented by the GTK GUI (gui.c) or the headless runner (cli.c)
+void update_log_view(SimulationState *state); // New records were added to state->log
+void update_gui(SimulationState *state); // Redraw the panels in state->dirty, at most once per frame
+
+// Flag panels as changed and ask the frontend for a refresh
+void mark_dirty(SimulationState *state, unsigned panels);
+
+// Render the PCB words and copy the words written since the last sync into
+// state->memory; changed (may be NULL) is told about each run of copied words
+void sync_memory_view(SimulationState *state, void (*changed)(int first, int count));
+
+// Rebuild readyQueue, blockedQueue (in wake order) and timeInQueue from the
+// scheduler; the simulation loop leaves them stale until a frontend asks
+void sync_queue_view(SimulationState *state);
+
+// Record a log event; format must be a string literal, it is kept as the event code
+void append_logf(SimulationState *state, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void append_log(SimulationState *state, const char *message);
+
+#endif
@@ -0,0 +1,317 @@
+// smp.c - per-core run queues, placement and load balancing for SMP mode
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "smp.h"
+#include "pcb.h"
+#include "arena.h"
+
+static Core* cores = NULL;
+static int numCores = 1;
+static int allocatedCores = 0;
+static int interval = 0;
+static BalancePolicy balancer = BALANCE_PUSH;
+static int migrationCost = 0;
+static int nextBalance = 0;
+static _Thread_local int current = -1; // Core this thread is stepping
+static SmpStats stats;
+
+static const char* policyNames[] = {"push", "steal"};
+
+const char* balancePolicyName(BalancePolicy policy) {
+    return policy >= BALANCE_PUSH && policy <= BALANCE_STEAL ? policyNames[policy] : "unknown";
+}
+
+int parseBalancePolicy(const char* name) {
+    for (int i = BALANCE_PUSH; i <= BALANCE_STEAL; i++) {
+        if (strcmp(name, policyNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+void smp_init(int count, int balanceInterval, BalancePolicy policy, int cost) {
+    if (count > 1 && count > allocatedCores) {
+        Core* grown = heap_realloc(cores, count * sizeof(Core));
+        if (grown == NULL) {
+            printf("memory error for %d cores\n", count);
+            exit(1);
+        }
+        memset(grown + allocatedCores, 0, (count - allocatedCores) * sizeof(Core));
+        cores = grown;
+        allocatedCores = count;
+    }
+    numCores = count;
+    for (int c = 0; c < allocatedCores; c++) {
+        for (int level = 0; level < NUM_QUEUES; level++) {
+            initializeQueue(&cores[c].queues[level]);
+        }
+        initializeQueue(&cores[c].unblocked);
+        cores[c].quantaCount = 0;
+        cores[c].busyCycles = 0;
+        cores[c].migrationsIn = 0;
+        cores[c].migrationsOut = 0;
+        cores[c].stealAttempts = 0;
+        cores[c].stall = 0;
+        cores[c].stalledCycles = 0;
+        cores[c].victimSeed = 2654435761u * (c + 1);
+    }
+    interval = balanceInterval;
+    balancer = policy;
+    migrationCost = cost;
+    nextBalance = balanceInterval;
+    current = -1;
+    memset(&stats, 0, sizeof(stats));
+    stats.cores = count;
+    stats.balancer = policy;
+}
+
+bool smp_enabled(void) {
+    return numCores > 1;
+}
+
+int smp_cores(void) {
+    return numCores;
+}
+
+Core* smp_core(int core) {
+    return &cores[core];
+}
+
+int smp_load(int core) {
+    int load = 0;
+    for (int level = 0; level < NUM_QUEUES; level++) {
+        load += countQueueElements(&cores[core].queues[level]);
+    }
+    return load;
+}
+
+// Cores a process may use, limited to the ones that exist
+static unsigned long long allowedCores(int slot) {
+    unsigned long long all = numCores == 64 ? ~0ULL : (1ULL << numCores) - 1;
+    return pcbTable.affinity[slot] & all;
+}
+
+// Least loaded core in the mask, lowest index on ties; -1 for an empty mask
+static int leastLoaded(unsigned long long mask) {
+    int best = -1;
+    int bestLoad = 0;
+    for (int c = 0; c < numCores; c++) {
+        if (!(mask & (1ULL << c))) continue;
+        int load = smp_load(c);
+        if (best == -1 || load < bestLoad) {
+            best = c;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+int smp_place(int pid) {
+    int slot = findPCB(pid);
+    if (slot == -1) return -1;
+    int core = leastLoaded(allowedCores(slot));
+    if (core == -1) core = 0; // Affinity is checked when the process is loaded
+    pcbTable.cpu[slot] = core;
+    enqueue(&cores[core].queues[0], pid);
+    return core;
+}
+
+// Next process a core would run. It is never migrated, so a quantum in
+// progress is not cut short.
+static int nextToRun(int core) {
+    for (int level = 0; level < NUM_QUEUES; level++) {
+        if (!isEmpty(&cores[core].queues[level])) return queueFirst(&cores[core].queues[level]);
+    }
+    return 0;
+}
+
+void smp_begin_step(int core) {
+    current = core;
+}
+
+void smp_end_step(void) {
+    current = -1;
+}
+
+// Queued processes that can still run: not waiting on a mutex or terminated
+static int runnable(int core) {
+    int count = 0;
+    for (int level = 0; level < NUM_QUEUES; level++) {
+        Queue* q = &cores[core].queues[level];
+        for (int pid = queueFirst(q); pid > 0; pid = queueNext(q, pid)) {
+            int slot = findPCB(pid);
+            if (slot != -1 && pcbTable.state[slot] != BLOCKED && pcbTable.state[slot] != TERMINATED) count++;
+        }
+    }
+    return count;
+}
+
+bool smp_other_cores_busy(void) {
+    if (numCores <= 1) return false;
+    for (int c = 0; c < numCores; c++) {
+        if (c != current && runnable(c) > 0) return true;
+    }
+    return false;
+}
+
+void smp_route_unblocked(int core) {
+    Queue* woken = &cores[core].unblocked;
+    for (int pid = queueFirst(woken), next; pid > 0; pid = next) {
+        next = queueNext(woken, pid);
+        int slot = findPCB(pid);
+        if (slot == -1 || pcbTable.cpu[slot] == core) continue;
+        removeFromQueue(woken, pid);
+        enqueue(&cores[pcbTable.cpu[slot]].unblocked, pid);
+    }
+}
+
+static void migrate(int pid, int slot, int from, int level, int to) {
+    removeFromQueue(&cores[from].queues[level], pid);
+    enqueue(&cores[to].queues[level], pid);
+    if (removeFromQueue(&cores[from].unblocked, pid)) {
+        enqueue(&cores[to].unblocked, pid);
+    }
+    pcbTable.cpu[slot] = to;
+    cores[from].migrationsOut++;
+    cores[to].migrationsIn++;
+    cores[to].stall += migrationCost;
+    stats.migrations++;
+    stats.migrationCycles += migrationCost;
+}
+
+bool smp_stalled(int core) {
+    Core* c = &cores[core];
+    if (c->stall == 0) return false;
+    if (smp_load(core) == 0) {
+        // Nothing left to warm up for; dropping the debt also keeps idle
+        // skipping from deferring it to whatever arrives next
+        c->stall = 0;
+        return false;
+    }
+    c->stall--;
+    c->stalledCycles++;
+    return true;
+}
+
+// Push one process from the busiest core to the least loaded core it may use,
+// taken from the back of the busiest core's lowest-priority queue. Only moves
+// that leave the target less loaded than the source are made.
+static bool pushOne(void) {
+    int busiest = 0;
+    int busiestLoad = smp_load(0);
+    for (int c = 1; c < numCores; c++) {
+        int load = smp_load(c);
+        if (load > busiestLoad) {
+            busiest = c;
+            busiestLoad = load;
+        }
+    }
+    if (busiestLoad < 2) return false;
+    int head = nextToRun(busiest);
+    for (int level = NUM_QUEUES - 1; level >= 0; level--) {
+        Queue* q = &cores[busiest].queues[level];
+        for (int pid = queueLast(q); pid > 0; pid = queuePrev(q, pid)) {
+            if (pid == head) continue;
+            int slot = findPCB(pid);
+            if (slot == -1) continue;
+            int target = leastLoaded(allowedCores(slot) & ~(1ULL << busiest));
+            if (target == -1 || smp_load(target) > busiestLoad - 2) continue;
+            migrate(pid, slot, busiest, level, target);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Victims are chosen at random from the other cores with a per-core xorshift
+// generator, so runs are still reproducible
+static int pickVictim(int thief) {
+    unsigned int x = cores[thief].victimSeed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    cores[thief].victimSeed = x;
+    int victim = (int)(x % (unsigned int)(numCores - 1));
+    return victim >= thief ? victim + 1 : victim;
+}
+
+// The thief takes the work the victim would get to last: the back of its
+// lowest-priority non-empty level, never its next process. Steals run one
+// after another in smp_tick, once every core has finished its step, so they
+// read and change the run queues directly.
+static void stealFor(int thief) {
+    cores[thief].stealAttempts++;
+    stats.stealAttempts++;
+    int victim = pickVictim(thief);
+    if (smp_load(victim) < 2) return;
+    int head = nextToRun(victim);
+    for (int level = NUM_QUEUES - 1; level >= 0; level--) {
+        Queue* q = &cores[victim].queues[level];
+        for (int pid = queueLast(q); pid > 0; pid = queuePrev(q, pid)) {
+            int slot = findPCB(pid);
+            if (pid == head || slot == -1) continue;
+            // A process the thief may not run stays for other cores
+            if (!(allowedCores(slot) & (1ULL << thief))) return;
+            migrate(pid, slot, victim, level, thief);
+            stats.steals++;
+            return;
+        }
+    }
+}
+
+static bool anyQueued(void) {
+    for (int c = 0; c < numCores; c++) {
+        if (smp_load(c) > 0) return true;
+    }
+    return false;
+}
+
+// Push passes fall on multiples of the interval, so skipping idle cycles (when
+// every core is empty and a pass has nothing to do) does not shift them.
+// Idle cores try to steal every cycle, but only while some core has work.
+void smp_tick(int clock) {
+    if (numCores <= 1) return;
+    if (balancer == BALANCE_STEAL) {
+        if (!anyQueued()) return;
+        for (int c = 0; c < numCores; c++) {
+            if (smp_load(c) == 0) stealFor(c);
+        }
+        return;
+    }
+    if (interval == 0 || clock < nextBalance) return;
+    nextBalance = (clock / interval + 1) * interval;
+    if (!anyQueued()) return;
+    stats.balancePasses++;
+    for (int moves = 0; moves < numCores && pushOne(); moves++) {
+    }
+}
+
+void smp_stats(SmpStats* out) {
+    *out = stats;
+}
+
+int parseAffinity(const char* text, unsigned long long* mask) {
+    unsigned long long bits = 0;
+    const char* p = text;
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0) return -1;
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return -1;
+        }
+        if (last >= MAX_CORES) return -1;
+        for (long c = first; c <= last; c++) {
+            bits |= 1ULL << c;
+        }
+        if (*end == ',') end++;
+        else if (*end != '\0') return -1;
+        p = end;
+    }
+    if (bits == 0) return -1;
+    *mask = bits;
+    return 0;
+}
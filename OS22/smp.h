@@ -0,0 +1,63 @@
+// smp.h
+#ifndef SMP_H
+#define SMP_H
+
+#include <stdbool.h>
+#include "simulation.h"
+
+typedef enum {
+    BALANCE_PUSH,  // Every balance_interval cycles, move work off the busiest core
+    BALANCE_STEAL  // Every cycle, each idle core tries to steal from another core
+} BalancePolicy;
+
+// One simulated CPU. With more than one core (the 'cores' setting) every core
+// keeps its own run queues and the selected scheduler runs once per core per
+// clock cycle; a process lives on one core at a time (pcbTable.cpu) and only
+// moves when the load balancer migrates it to another core in its affinity mask.
+typedef struct {
+    Queue queues[NUM_QUEUES]; // MLFQ levels; RR and FCFS use the first
+    Queue unblocked;          // Woken by semSignal, picked up by the RR scheduler
+    int quantaCount;          // RR quantum left for the process at the head
+    long busyCycles;          // Cycles spent executing instructions
+    long migrationsIn;
+    long migrationsOut;
+    long stealAttempts;       // Steals tried while idle (steal balancer)
+    int stall;                // Cycles left before a migrated process can run here
+    long stalledCycles;       // Cycles lost to migration cost
+    unsigned int victimSeed;  // Picks steal victims; seeded from the core index
+} Core;
+
+typedef struct {
+    int cores;
+    BalancePolicy balancer;
+    long balancePasses;  // Periodic balancing passes run (push balancer)
+    long stealAttempts;  // Idle cores looking for work (steal balancer)
+    long steals;         // Attempts that moved a process
+    long migrations;
+    long migrationCycles; // Cycles cores were stalled by migrations
+} SmpStats;
+
+// Empties every core; run queues keep their storage. Each migration stalls
+// the receiving core for 'migrationCost' cycles.
+void smp_init(int cores, int balanceInterval, BalancePolicy balancer, int migrationCost);
+bool smp_enabled(void);                        // More than one core
+int smp_cores(void);
+Core* smp_core(int core);
+int smp_load(int core);                        // Processes in the core's run queues
+
+int smp_place(int pid);                  // Arriving process: least loaded allowed core, returns it
+void smp_begin_step(int core);           // The scheduler is about to run on 'core'
+void smp_end_step(void);
+bool smp_other_cores_busy(void);         // Another core has a queued process that can run
+void smp_route_unblocked(int core);      // Send woken processes to the core that holds them
+bool smp_stalled(int core);              // Pays one cycle of migration cost if it owes any
+void smp_tick(int clock);                // Steal for idle cores, or balance if a pass is due
+void smp_stats(SmpStats* stats);
+
+const char* balancePolicyName(BalancePolicy policy);
+int parseBalancePolicy(const char* name); // BalancePolicy value, -1 if unknown
+
+// "0-3,8" style core list, -1 if malformed or a core is out of range
+int parseAffinity(const char* text, unsigned long long* mask);
+
+#endif
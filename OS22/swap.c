@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "swap.h"
+#include "pcb.h"
+#include "instruction.h"
+#include "arena.h"
+
+#define SWAP_MAGIC 0x50415753u // "SWAP"
+
+typedef struct {
+    unsigned int magic;
+    int pid;
+    int words;
+    int textBytes;
+} SwapHeader;
+
+// Run of free pages inside the backing file
+typedef struct {
+    int page;
+    int pages;
+} Extent;
+
+static int fd = -1;
+static VictimPolicy victimPolicy = VICTIM_FIFO;
+static SwapStats stats;
+static Extent* holes = NULL; // Sorted by page, neighbours merged
+static int numHoles = 0;
+static int holesCapacity = 0;
+static char* buffer = NULL;  // Staging area for one record, grown as needed
+static size_t bufferSize = 0;
+static long* residentSince = NULL; // Per slot, for FIFO victims
+static int residentCapacity = 0;
+static long residentClock = 0;
+
+static const char* policyNames[] = {"fifo", "largest", "blocked"};
+
+const char* victimPolicyName(VictimPolicy policy) {
+    return policy >= VICTIM_FIFO && policy <= VICTIM_BLOCKED ? policyNames[policy] : "unknown";
+}
+
+int parseVictimPolicy(const char* name) {
+    for (int i = VICTIM_FIFO; i <= VICTIM_BLOCKED; i++) {
+        if (strcmp(name, policyNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int swap_open(const char* path, VictimPolicy policy) {
+    swap_close();
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        printf("Cannot open swap file %s\n", path);
+        return -1;
+    }
+    victimPolicy = policy;
+    memset(&stats, 0, sizeof(stats));
+    numHoles = 0;
+    residentClock = 0;
+    if (residentSince) memset(residentSince, 0, residentCapacity * sizeof(long));
+    return 0;
+}
+
+void swap_close(void) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+int swap_enabled(void) {
+    return fd >= 0;
+}
+
+static int reserveBuffer(size_t size) {
+    if (size <= bufferSize) return 1;
+    char* grown = heap_realloc(buffer, size);
+    if (grown == NULL) {
+        printf("memory error for swap buffer\n");
+        return 0;
+    }
+    buffer = grown;
+    bufferSize = size;
+    return 1;
+}
+
+// First run of free pages that is long enough, else the end of the file
+static int takePages(int pages) {
+    for (int i = 0; i < numHoles; i++) {
+        if (holes[i].pages < pages) continue;
+        int page = holes[i].page;
+        holes[i].page += pages;
+        holes[i].pages -= pages;
+        if (holes[i].pages == 0) {
+            memmove(&holes[i], &holes[i + 1], (numHoles - i - 1) * sizeof(Extent));
+            numHoles--;
+        }
+        stats.pagesInUse += pages;
+        return page;
+    }
+    int page = stats.filePages;
+    stats.filePages += pages;
+    stats.pagesInUse += pages;
+    return page;
+}
+
+static void releasePages(int page, int pages) {
+    if (numHoles == holesCapacity) {
+        int capacity = holesCapacity ? holesCapacity * 2 : 16;
+        Extent* grown = heap_realloc(holes, capacity * sizeof(Extent));
+        if (grown == NULL) return; // The pages stay unused
+        holes = grown;
+        holesCapacity = capacity;
+    }
+    int i = 0;
+    while (i < numHoles && holes[i].page < page) i++;
+    memmove(&holes[i + 1], &holes[i], (numHoles - i) * sizeof(Extent));
+    holes[i].page = page;
+    holes[i].pages = pages;
+    numHoles++;
+    stats.pagesInUse -= pages;
+    if (i + 1 < numHoles && page + pages == holes[i + 1].page) {
+        holes[i].pages += holes[i + 1].pages;
+        memmove(&holes[i + 1], &holes[i + 2], (numHoles - i - 2) * sizeof(Extent));
+        numHoles--;
+    }
+    if (i > 0 && holes[i - 1].page + holes[i - 1].pages == page) {
+        holes[i - 1].pages += holes[i].pages;
+        memmove(&holes[i], &holes[i + 1], (numHoles - i - 1) * sizeof(Extent));
+        numHoles--;
+    }
+}
+
+long swap_out_image(int pid, int first, int count) {
+    if (fd < 0) return -1;
+    size_t maxBytes = sizeof(SwapHeader) + (size_t)count * (sizeof(Instruction) + MAX_LINE_LENGTH);
+    if (!reserveBuffer(maxBytes)) return -1;
+
+    SwapHeader header = {SWAP_MAGIC, pid, count, 0};
+    size_t bytes = sizeof(header);
+    memcpy(buffer + bytes, &decoded[first], count * sizeof(Instruction));
+    bytes += count * sizeof(Instruction);
+    for (int i = first; i < first + count; i++) {
+        size_t length = strnlen(memory[i], MAX_LINE_LENGTH - 1);
+        memcpy(buffer + bytes, memory[i], length);
+        buffer[bytes + length] = '\0';
+        bytes += length + 1;
+        header.textBytes += length + 1;
+    }
+    memcpy(buffer, &header, sizeof(header));
+
+    int pages = (bytes + SWAP_PAGE_SIZE - 1) / SWAP_PAGE_SIZE;
+    int page = takePages(pages);
+    long offset = (long)page * SWAP_PAGE_SIZE;
+    double start = now();
+    ssize_t written = pwrite(fd, buffer, bytes, offset);
+    stats.seconds += now() - start;
+    if (written != (ssize_t)bytes) {
+        printf("Swap write failed for PID %d\n", pid);
+        releasePages(page, pages);
+        return -1;
+    }
+    stats.swapOuts++;
+    stats.bytesWritten += bytes;
+    return offset;
+}
+
+int swap_in_image(long offset, int pid, int first) {
+    SwapHeader header;
+    double start = now();
+    ssize_t got = pread(fd, &header, sizeof(header), offset);
+    if (got != (ssize_t)sizeof(header) || header.magic != SWAP_MAGIC || header.pid != pid) {
+        stats.seconds += now() - start;
+        printf("Swap record for PID %d is damaged\n", pid);
+        return -1;
+    }
+    size_t bytes = sizeof(header) + header.words * sizeof(Instruction) + header.textBytes;
+    if (!reserveBuffer(bytes)) return -1;
+    got = pread(fd, buffer, bytes, offset);
+    stats.seconds += now() - start;
+    if (got != (ssize_t)bytes) {
+        printf("Swap read failed for PID %d\n", pid);
+        return -1;
+    }
+
+    const char* p = buffer + sizeof(header);
+    memcpy(&decoded[first], p, header.words * sizeof(Instruction));
+    p += header.words * sizeof(Instruction);
+    for (int i = first; i < first + header.words; i++) {
+        size_t length = strlen(p);
+        memcpy(memory[i], p, length + 1);
+        p += length + 1;
+    }
+    releasePages(offset / SWAP_PAGE_SIZE, (bytes + SWAP_PAGE_SIZE - 1) / SWAP_PAGE_SIZE);
+    stats.swapIns++;
+    stats.bytesRead += bytes;
+    return 0;
+}
+
+void swap_resident(int slot) {
+    if (slot >= residentCapacity) {
+        int capacity = pcbTable.capacity > slot ? pcbTable.capacity : slot + 1;
+        long* grown = heap_realloc(residentSince, capacity * sizeof(long));
+        if (grown == NULL) return;
+        memset(grown + residentCapacity, 0, (capacity - residentCapacity) * sizeof(long));
+        residentSince = grown;
+        residentCapacity = capacity;
+    }
+    residentSince[slot] = ++residentClock;
+}
+
+static int evictable(int slot, int excludeA, int excludeB) {
+    return pcbTable.used[slot] && pcbTable.swapOffset[slot] < 0 && slot != excludeA && slot != excludeB &&
+           pcbTable.state[slot] != TERMINATED && pcbTable.state[slot] != RUNNING;
+}
+
+static long since(int slot) {
+    return slot < residentCapacity ? residentSince[slot] : 0;
+}
+
+static int oldest(int excludeA, int excludeB, int blockedOnly) {
+    int victim = -1;
+    for (int slot = 0; slot < pcbTable.capacity; slot++) {
+        if (!evictable(slot, excludeA, excludeB)) continue;
+        if (blockedOnly && pcbTable.state[slot] != BLOCKED) continue;
+        if (victim == -1 || since(slot) < since(victim)) victim = slot;
+    }
+    return victim;
+}
+
+static int pickFifo(int excludeA, int excludeB) {
+    return oldest(excludeA, excludeB, 0);
+}
+
+static int pickLargest(int excludeA, int excludeB) {
+    int victim = -1;
+    int largest = 0;
+    for (int slot = 0; slot < pcbTable.capacity; slot++) {
+        if (!evictable(slot, excludeA, excludeB)) continue;
+        int size = pcbTable.upperBound[slot] - pcbTable.lowerBound[slot] + 1;
+        if (size > largest) {
+            largest = size;
+            victim = slot;
+        }
+    }
+    return victim;
+}
+
+static int pickBlocked(int excludeA, int excludeB) {
+    int victim = oldest(excludeA, excludeB, 1);
+    return victim != -1 ? victim : oldest(excludeA, excludeB, 0);
+}
+
+// Indexed by VictimPolicy
+static int (*const pickers[])(int excludeA, int excludeB) = {pickFifo, pickLargest, pickBlocked};
+
+int swap_pick_victim(int excludeA, int excludeB) {
+    return pickers[victimPolicy](excludeA, excludeB);
+}
+
+void swap_stats(SwapStats* out) {
+    *out = stats;
+}
@@ -0,0 +1,38 @@
+// swap.h
+#ifndef SWAP_H
+#define SWAP_H
+
+#define SWAP_PAGE_SIZE 4096 // Records start on page boundaries of the backing file
+
+// Which resident process to evict when memory is needed (the 'swap_policy' setting)
+typedef enum {
+    VICTIM_FIFO,    // Resident the longest
+    VICTIM_LARGEST, // Largest image, frees the most words per swap
+    VICTIM_BLOCKED  // A blocked process if there is one, otherwise FIFO
+} VictimPolicy;
+
+typedef struct {
+    long swapIns;
+    long swapOuts;
+    long bytesWritten;
+    long bytesRead;
+    double seconds;  // Wall time spent in pread/pwrite
+    int pagesInUse;  // Backing file pages holding swapped images
+    int filePages;   // Pages the backing file has grown to
+} SwapStats;
+
+// A swapped image is one record: a header, the decoded instructions as raw
+// structs and then each word's text packed end to end with its terminator.
+// Records take whole pages and freed page runs are reused.
+int swap_open(const char* path, VictimPolicy policy); // Creates or truncates the backing file, -1 on error
+void swap_close(void);
+int swap_enabled(void);
+long swap_out_image(int pid, int first, int count);  // Record offset, or -1 on an I/O error
+int swap_in_image(long offset, int pid, int first);  // Restores the image at 'first' and frees its pages
+void swap_resident(int slot);                        // Slot was loaded or swapped in
+int swap_pick_victim(int excludeA, int excludeB);    // Resident slot to swap out, -1 if none
+void swap_stats(SwapStats* stats);
+const char* victimPolicyName(VictimPolicy policy);
+int parseVictimPolicy(const char* name);             // VictimPolicy value, -1 if unknown
+
+#endif
@@ -0,0 +1,71 @@
+// workers.c - fixed pool of host threads synchronized by two barriers per run
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "workers.h"
+#include "arena.h"
+
+static pthread_t* threads = NULL;
+static int numThreads = 1; // Including the thread that calls workers_run
+static pthread_barrier_t begin; // Releases the workers into a run
+static pthread_barrier_t done;  // Every item of the run has finished
+static void (*task)(int item);
+static int items;
+static atomic_int nextItem;
+
+// Items are handed out one at a time, so a slow one does not hold up the rest
+static void claim(void) {
+    for (int item; (item = atomic_fetch_add_explicit(&nextItem, 1, memory_order_relaxed)) < items;) {
+        task(item);
+    }
+}
+
+static void* worker(void* unused) {
+    (void)unused;
+    for (;;) {
+        pthread_barrier_wait(&begin);
+        claim();
+        pthread_barrier_wait(&done);
+    }
+    return NULL;
+}
+
+int workers_start(int count) {
+    if (threads != NULL || count <= 1) return 0; // The first pool is kept
+    threads = heap_calloc(count - 1, sizeof(pthread_t));
+    if (threads == NULL) {
+        printf("memory error for %d threads\n", count);
+        return -1;
+    }
+    pthread_barrier_init(&begin, NULL, count);
+    pthread_barrier_init(&done, NULL, count);
+    for (int i = 0; i < count - 1; i++) {
+        if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+            // The ones already started wait on the barrier until the program exits
+            printf("Cannot start thread %d of %d\n", i + 1, count);
+            threads = NULL;
+            return -1;
+        }
+    }
+    numThreads = count;
+    return 0;
+}
+
+int workers_count(void) {
+    return numThreads;
+}
+
+void workers_run(void (*run)(int item), int count) {
+    if (threads == NULL || count < 2) {
+        for (int item = 0; item < count; item++) {
+            run(item);
+        }
+        return;
+    }
+    task = run;
+    items = count;
+    atomic_store_explicit(&nextItem, 0, memory_order_relaxed);
+    pthread_barrier_wait(&begin); // Also publishes task and items
+    claim();
+    pthread_barrier_wait(&done);
+}
@@ -0,0 +1,12 @@
+// workers.h
+#ifndef WORKERS_H
+#define WORKERS_H
+
+// Host threads for stepping simulated cores in parallel (the 'threads'
+// setting). The calling thread works alongside them, and every run ends at a
+// barrier, so nothing it started is still running when workers_run returns.
+int workers_start(int threads);                      // Total threads, including the caller; -1 on error
+int workers_count(void);                             // 1 when no pool was started
+void workers_run(void (*task)(int item), int items); // task(0) .. task(items - 1), in any order
+
+#endif